@@ -54,7 +54,9 @@ endfunction(piglit_include_target_api)
 # This function wraps `add_executable` and has the same signature.
 #
 # In addition to calling `add_executable`, it adds to each object file
-# a dependency on piglit_dispatch's generated files.
+# a dependency on piglit_dispatch's generated files.  With
+# PIGLIT_BUILD_TEST_MODULES it also builds ${name}_module, a module with
+# the same sources for piglit-test-host.
 #
 function(piglit_add_executable name)
 
@@ -66,6 +68,26 @@ function(piglit_add_executable name)
 
     install(TARGETS ${name} DESTINATION ${PIGLIT_INSTALL_LIBDIR}/bin)
 
+    # The module gets the same sources, and picks up the libraries, include
+    # directories and definitions that are added to the executable after
+    # this call through generator expressions.
+    if(PIGLIT_BUILD_TEST_MODULES)
+        add_library(${name}_module MODULE ${ARGV})
+        add_dependencies(${name}_module piglit_dispatch_gen)
+        target_link_libraries(${name}_module
+            $<TARGET_PROPERTY:${name},LINK_LIBRARIES>)
+        target_include_directories(${name}_module PRIVATE
+            $<TARGET_PROPERTY:${name},INCLUDE_DIRECTORIES>)
+        target_compile_definitions(${name}_module PRIVATE
+            $<TARGET_PROPERTY:${name},COMPILE_DEFINITIONS>)
+        set_target_properties(${name}_module PROPERTIES
+            OUTPUT_NAME ${name}
+            PREFIX ""
+            LIBRARY_OUTPUT_DIRECTORY ${piglit_BINARY_DIR}/lib/test-modules)
+        install(TARGETS ${name}_module
+                DESTINATION ${PIGLIT_INSTALL_LIBDIR}/lib/test-modules)
+    endif()
+
 endfunction(piglit_add_executable)
 
 #
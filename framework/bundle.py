@@ -0,0 +1,294 @@
+# Copyright © 2026 The Piglit project
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""Indexed bundle of shader_test and glslparsertest sources.
+
+A bundle packs every test source under one or more root directories into a
+single file, so that loading tests costs one mmap instead of an open, stat and
+read per file. piglit_load_text_file() and the Python parsers read files from
+the bundle named by PIGLIT_SHADER_BUNDLE, and fall back to the filesystem for
+anything that isn't in it, or that was modified after the bundle was packed.
+
+The layout, all integers little endian, is:
+
+    0   8 bytes  magic, "PIGLITBN"
+    8   u32      format version, 2
+    12  u32      number of entries
+    16  u32      number of roots
+    20  u32      reserved, 0
+    24  u64      offset of the index
+    32           roots, each a u32 length followed by that many bytes of
+                 absolute directory path
+    index        one entry per file, sorted by name:
+                 u64 name offset, u64 data offset, u32 name length,
+                 u32 data length, i64 mtime of the file in seconds, or 0
+                 for entries that aren't files
+    ...          names, and file contents each followed by a NUL byte
+
+Names are paths relative to the root the file was found under, with '/' as
+the separator.  The entry REQUIREMENTS_ENTRY holds the [require] block of
+every shader_test as parsed by shader_test.Parser, as JSON.
+
+Bundles are written with "python -m framework.bundle", usually through the
+shader-bundle build target.
+"""
+
+from __future__ import (
+    absolute_import, division, print_function, unicode_literals
+)
+import argparse
+import io
+import json
+import mmap
+import os
+import struct
+
+__all__ = [
+    'Bundle',
+    'pack',
+    'read_text',
+    'requirements',
+]
+
+MAGIC = b'PIGLITBN'
+VERSION = 2
+REQUIREMENTS_ENTRY = '.piglit/requirements.json'
+EXTENSIONS = frozenset(['.shader_test', '.vert', '.tesc', '.tese', '.geom',
+                        '.frag', '.comp'])
+
+_HEADER = struct.Struct('<8sIIIIQ')
+_ENTRY = struct.Struct('<QQIIq')
+
+
+class Bundle(object):
+    """A read-only view of a bundle file."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+        magic, version, count, num_roots, _, index = \
+            _HEADER.unpack_from(self._map, 0)
+        if magic != MAGIC or version != VERSION:
+            raise ValueError('{} is not a version {} piglit bundle'.format(
+                path, VERSION))
+
+        self.roots = []
+        offset = _HEADER.size
+        for _ in range(num_roots):
+            length, = struct.unpack_from('<I', self._map, offset)
+            offset += 4
+            self.roots.append(
+                self._map[offset:offset + length].decode('utf-8'))
+            offset += length
+
+        self._entries = {}
+        for i in range(count):
+            name_off, data_off, name_len, data_len, mtime = \
+                _ENTRY.unpack_from(self._map, index + i * _ENTRY.size)
+            name = self._map[name_off:name_off + name_len].decode('utf-8')
+            self._entries[name] = (data_off, data_len, mtime)
+
+    def _name(self, path):
+        """Map a filesystem path to an entry name, or None."""
+        path = os.path.abspath(path)
+        for root in self.roots:
+            if path.startswith(root + os.sep):
+                return path[len(root) + 1:].replace(os.sep, '/')
+        return None
+
+    def _entry(self, path):
+        """Return the entry of path, or None if it isn't bundled.
+
+        Entries packed from a file are only returned while the file at path
+        still has the size and mtime it was packed with, edits made since
+        are read from disk.
+
+        """
+        entry = self._entries.get(self._name(path))
+        if entry is None:
+            entry = self._entries.get(path.replace(os.sep, '/'))
+        if entry is None or not entry[2]:
+            return entry
+
+        try:
+            st = os.stat(path)
+        except OSError:
+            return None
+        if st.st_size != entry[1] or int(st.st_mtime) != entry[2]:
+            return None
+        return entry
+
+    def get(self, path):
+        """Return the contents of path as bytes, or None if not bundled.
+
+        path may be a filesystem path below one of the roots, or an entry
+        name.
+
+        """
+        entry = self._entry(path)
+        if entry is None:
+            return None
+        return self._map[entry[0]:entry[0] + entry[1]]
+
+    def get_entry(self, name):
+        """Return the contents of the entry name as bytes, or None."""
+        entry = self._entries.get(name)
+        if entry is None:
+            return None
+        return self._map[entry[0]:entry[0] + entry[1]]
+
+
+_BUNDLE = None
+_REQUIREMENTS = None
+
+
+def _get_bundle():
+    global _BUNDLE  # pylint: disable=global-statement
+    if _BUNDLE is None:
+        path = os.environ.get('PIGLIT_SHADER_BUNDLE')
+        _BUNDLE = Bundle(path) if path else False
+    return _BUNDLE
+
+
+def read_text(path):
+    """Read a test source as text, from the bundle if it's in there."""
+    bundle = _get_bundle()
+    data = bundle.get(path) if bundle else None
+    if data is not None:
+        return data.decode('utf-8')
+
+    with io.open(path, mode='r', encoding='utf-8') as f:
+        return f.read()
+
+
+def requirements(path):
+    """Return the precomputed shader_test requirements of path, or None."""
+    global _REQUIREMENTS  # pylint: disable=global-statement
+    bundle = _get_bundle()
+    if not bundle:
+        return None
+
+    if _REQUIREMENTS is None:
+        data = bundle.get_entry(REQUIREMENTS_ENTRY)
+        _REQUIREMENTS = json.loads(data.decode('utf-8')) if data else {}
+
+    # pylint: disable=protected-access
+    if bundle._entry(path) is None:
+        return None
+    return _REQUIREMENTS.get(bundle._name(path))
+
+
+def _collect(roots):
+    """Return a sorted list of (name, path) for every test source."""
+    files = {}
+    for root in roots:
+        for dirpath, _, filenames in os.walk(root):
+            for filename in filenames:
+                if os.path.splitext(filename)[1] not in EXTENSIONS:
+                    continue
+                path = os.path.join(dirpath, filename)
+                name = os.path.relpath(path, root).replace(os.sep, '/')
+                files.setdefault(name, path)
+    return sorted(files.items())
+
+
+def _parse_requirements(files):
+    # Imported here, the parsers read files through this module.
+    from framework.test.shader_test import Parser
+
+    reqs = {}
+    for name, path in files:
+        if not name.endswith('.shader_test'):
+            continue
+        parser = Parser(path)
+        try:
+            parser.parse()
+        except Exception:  # pylint: disable=broad-except
+            # Leave it to the runner to report broken tests.
+            continue
+        reqs[name] = parser.to_dict()
+    return reqs
+
+
+def pack(output, roots):
+    """Write a bundle of every test source under roots to output."""
+    global _BUNDLE  # pylint: disable=global-statement
+
+    # Parse the sources on disk, not the bundle that is being replaced.
+    _BUNDLE = False
+
+    roots = [os.path.abspath(r) for r in roots]
+    files = _collect(roots)
+    contents = []
+    for name, path in files:
+        with open(path, 'rb') as f:
+            mtime = int(os.fstat(f.fileno()).st_mtime)
+            contents.append((name.encode('utf-8'), f.read(), mtime))
+
+    reqs = json.dumps(_parse_requirements(files), sort_keys=True)
+    contents.append((REQUIREMENTS_ENTRY.encode('utf-8'), reqs.encode('utf-8'),
+                     0))
+    contents.sort()
+
+    roots_blob = b''.join(struct.pack('<I', len(r.encode('utf-8'))) +
+                          r.encode('utf-8') for r in roots)
+    index_offset = _HEADER.size + len(roots_blob)
+    index_offset += -index_offset % 8
+    offset = index_offset + len(contents) * _ENTRY.size
+
+    index = []
+    blobs = []
+    for name, data, mtime in contents:
+        index.append(_ENTRY.pack(offset, offset + len(name), len(name),
+                                 len(data), mtime))
+        blobs.append(name)
+        blobs.append(data + b'\0')
+        offset += len(name) + len(data) + 1
+
+    tmp = output + '.tmp'
+    with open(tmp, 'wb') as f:
+        f.write(_HEADER.pack(MAGIC, VERSION, len(contents), len(roots), 0,
+                             index_offset))
+        f.write(roots_blob)
+        f.write(b'\0' * (index_offset - _HEADER.size - len(roots_blob)))
+        f.write(b''.join(index))
+        f.write(b''.join(blobs))
+    os.rename(tmp, output)
+
+    return len(contents)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Pack shader_test and glslparsertest sources into an '
+                    'indexed bundle for PIGLIT_SHADER_BUNDLE.')
+    parser.add_argument('-o', '--output', required=True,
+                        help='bundle file to write')
+    parser.add_argument('roots', nargs='+',
+                        help='directories to search for test sources')
+    args = parser.parse_args()
+
+    count = pack(args.output, args.roots)
+    print('Packed {} files into {}'.format(count, args.output))
+
+
+if __name__ == '__main__':
+    main()
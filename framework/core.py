@@ -44,7 +44,8 @@ __all__ = [
     'parse_listfile',
 ]
 
-PLATFORMS = ["glx", "x11_egl", "wayland", "gbm", "mixed_glx_egl", "wgl"]
+PLATFORMS = ["glx", "x11_egl", "wayland", "gbm", "surfaceless_egl",
+             "mixed_glx_egl", "wgl"]
 
 
 class PiglitConfig(configparser.SafeConfigParser):
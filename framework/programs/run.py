@@ -28,6 +28,7 @@ import os
 import os.path as path
 import re
 import shutil
+import subprocess
 import sys
 import time
 
@@ -38,6 +39,7 @@ from framework import dmesg
 from framework import exceptions
 from framework import monitoring
 from framework import profile
+from framework import xvfb
 from framework.results import TimeAttribute
 from . import parsers
 
@@ -208,6 +210,24 @@ def _run_parser(input_):
                              'isolation. This allows, but does not require, '
                              'tests to run multiple tests per process. '
                              'This value can also be set in piglit.conf.')
+    parser.add_argument('--xvfb-displays',
+                        dest='xvfb_displays',
+                        action='store',
+                        type=int,
+                        default=int(core.PIGLIT_CONFIG.safe_get(
+                            'core', 'xvfb displays', '0')),
+                        metavar='<int>',
+                        help='Start this many Xvfb servers and spread the '
+                             'tests over them, instead of running them all '
+                             'on DISPLAY. Useful with many concurrent X11 '
+                             'tests. This value can also be set in '
+                             'piglit.conf.')
+    parser.add_argument('--refresh-caps',
+                        dest='refresh_caps',
+                        action='store_true',
+                        help='Rewrite the driver capability snapshots in '
+                             'PIGLIT_CAPS_DIR, and forget the contexts '
+                             'recorded as failing to create, before running.')
     parser.add_argument("--ignore-missing",
                         dest="ignore_missing",
                         action="store_true",
@@ -274,6 +294,47 @@ def _results_handler(path):
         os.unlink(path)
 
 
+def _snapshot_caps(refresh=False):
+    """Write the driver capability snapshots tests skip early with.
+
+    This only does anything when PIGLIT_CAPS_DIR is set.  piglit-caps-snapshot
+    returns without creating a context if the snapshot for the current driver
+    already exists, so this is cheap after the first run.  With refresh the
+    snapshots are rewritten and the recorded context failures dropped.
+
+    With --xvfb-displays this must run after xvfb.start(), so that the
+    snapshots describe the driver of the servers the tests run on.
+
+    """
+    if not os.environ.get('PIGLIT_CAPS_DIR'):
+        return
+
+    from framework.test.piglit_test import TEST_BIN_DIR
+    snapshots = [
+        ('piglit-caps-snapshot', 'compat'),
+        ('piglit-caps-snapshot', 'core'),
+        ('piglit-caps-snapshot_gles2', 'es'),
+    ]
+
+    display = xvfb.acquire()
+    try:
+        env = os.environ.copy()
+        env.update(options.OPTIONS.env)
+        env.update(xvfb.display_env(display))
+        for binary, profile_ in snapshots:
+            binary = path.join(TEST_BIN_DIR, binary)
+            if not path.exists(binary):
+                continue
+            command = [binary, profile_, '-auto', '-fbo']
+            if refresh:
+                command.append('-force')
+            with open(os.devnull, 'w') as devnull:
+                subprocess.call(command, env=env,
+                                stdout=devnull, stderr=devnull)
+    finally:
+        xvfb.release(display)
+
+
 @exceptions.handler
 def run(input_):
     """ Function for piglit run command
@@ -296,6 +357,7 @@ def run(input_):
     options.OPTIONS.sync = args.sync
     options.OPTIONS.deqp_mustpass = args.deqp_mustpass
     options.OPTIONS.process_isolation = args.process_isolation
+    options.OPTIONS.xvfb_displays = args.xvfb_displays
 
     # Set the platform to pass to waffle
     options.OPTIONS.env['PIGLIT_PLATFORM'] = args.platform
@@ -364,7 +426,12 @@ def run(input_):
         if args.include_tests:
             p.filters.append(profile.RegexFilter(args.include_tests))
 
-    profile.run(profiles, args.log_level, backend, args.concurrency)
+    xvfb.start(args.xvfb_displays)
+    try:
+        _snapshot_caps(args.refresh_caps)
+        profile.run(profiles, args.log_level, backend, args.concurrency)
+    finally:
+        xvfb.stop()
 
     time_elapsed.end = time.time()
     backend.finalize({'time_elapsed': time_elapsed.to_json()})
@@ -398,6 +465,7 @@ def resume(input_):
     options.OPTIONS.sync = results.options['sync']
     options.OPTIONS.deqp_mustpass = results.options['deqp_mustpass']
     options.OPTIONS.process_isolation = results.options['process_isolation']
+    options.OPTIONS.xvfb_displays = results.options.get('xvfb_displays', 0)
 
     core.get_config(args.config_file)
 
@@ -448,7 +516,9 @@ def resume(input_):
             p.forced_test_list = results.options['forced_test_list']
 
     # This is resumed, don't bother with time since it won't be accurate anyway
+    xvfb.start(options.OPTIONS.xvfb_displays)
     try:
+        _snapshot_caps()
         profile.run(
             profiles,
             results.options['log_level'],
@@ -457,6 +527,8 @@ def resume(input_):
     except exceptions.PiglitUserError as e:
         if str(e) != 'no matching tests':
             raise
+    finally:
+        xvfb.stop()
 
     backend.finalize()
 
@@ -148,7 +148,8 @@ class TestResult(object):
     """An object represting the result of a single test."""
     __slots__ = ['returncode', '_err', '_out', 'time', 'command', 'traceback',
                  'environment', 'subtests', 'dmesg', '__result', 'images',
-                 'exception', 'pid']
+                 'exception', 'pid', 'resources',
+                 'readback_hashes']
     err = StringDescriptor('_err')
     out = StringDescriptor('_out')
 
@@ -163,6 +164,8 @@ class TestResult(object):
         self.traceback = None
         self.exception = None
         self.pid = []
+        self.resources = {}
+        self.readback_hashes = {}
         if result:
             self.result = result
         else:
@@ -206,6 +209,8 @@ class TestResult(object):
             'traceback': self.traceback,
             'dmesg': self.dmesg,
             'pid': self.pid,
+            'resources': self.resources,
+            'readback_hashes': self.readback_hashes,
         }
         return obj
 
@@ -225,7 +230,8 @@ class TestResult(object):
         inst = cls()
 
         for each in ['returncode', 'command', 'exception', 'environment',
-                     'traceback', 'dmesg', 'pid', 'result']:
+                     'traceback', 'dmesg', 'pid', 'result', 'resources',
+                     'readback_hashes']:
             if each in dict_:
                 setattr(inst, each, dict_[each])
 
@@ -251,7 +257,26 @@ class TestResult(object):
         dictionary data and updates itself.
 
         """
-        if 'result' in dict_:
+        # Resource reports (PIGLIT_REPORT_RESOURCES) and readback hashes
+        # (PIGLIT_READBACK_HASH) carry the name of the subtest they belong
+        # to, so they must be checked first.  Subtest names are lowercased
+        # to match the keys of self.subtests.
+        if 'resources' in dict_:
+            resources = dict(dict_['resources'])
+            subtest = resources.pop('subtest', None)
+            if subtest is not None:
+                subtests = self.resources.setdefault('subtests', {})
+                subtests[subtest.lower()] = resources
+            else:
+                self.resources.update(resources)
+        elif 'readback_hash' in dict_:
+            hash_ = dict_['readback_hash']
+            if 'subtest' in hash_:
+                subtests = self.readback_hashes.setdefault('subtests', {})
+                subtests[hash_['subtest'].lower()] = hash_['hash']
+            else:
+                self.readback_hashes['hash'] = hash_['hash']
+        elif 'result' in dict_:
             self.result = dict_['result']
         elif 'subtest' in dict_:
             self.subtests.update(dict_['subtest'])
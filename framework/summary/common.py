@@ -126,6 +126,27 @@ class Names(object):
 
         return self.__diff(operator.ne, handler=handler)
 
+    @lazy_property
+    def output_changes(self):
+        """Tests with the same result, but different readback hashes.
+
+        Only tests that reported a readback hash (PIGLIT_READBACK_HASH) in
+        both runs are compared.
+
+        """
+        ret = ['']
+        for prev, cur in zip(self.__results[:-1], self.__results[1:]):
+            names = set()
+            for name in self.all:
+                prev_hash = _readback_hash(prev, name)
+                cur_hash = _readback_hash(cur, name)
+                if (prev_hash is not None and cur_hash is not None and
+                        prev_hash != cur_hash and
+                        prev.get_result(name) == cur.get_result(name)):
+                    names.add(name)
+            ret.append(names)
+        return ret
+
     @lazy_property
     def problems(self):
         return self.__single(lambda x: x > so.PASS)
@@ -179,6 +200,13 @@ class Names(object):
         else:
             return set()
 
+    @lazy_property
+    def all_output_changes(self):
+        if len(self.output_changes) > 1:
+            return set.union(*self.output_changes[1:])
+        else:
+            return set()
+
     @lazy_property
     def all_disabled(self):
         if len(self.disabled) > 1:
@@ -292,6 +320,17 @@ def _result_in(name, result):
         return False
 
 
+def _readback_hash(result, name):
+    """Return the readback hash of a test or subtest, or None."""
+    if name in result.tests:
+        return result.tests[name].readback_hashes.get('hash')
+    group, subtest = grouptools.splitname(name)
+    if group in result.tests:
+        hashes = result.tests[group].readback_hashes.get('subtests', {})
+        return hashes.get(subtest.lower())
+    return None
+
+
 def find_diffs(results, tests, comparator, handler=lambda *a: None):
     """Generate diffs between two or more sets of results.
 
@@ -117,6 +117,9 @@ def console(resultsFiles, mode):
         _print_summary(results)
     elif mode == 'diff':
         _print_result(results, results.names.all_changes)
+        if results.names.all_output_changes:
+            print("\nreadback changed, same result:")
+            _print_result(results, results.names.all_output_changes)
         _print_summary(results)
     elif mode == 'incomplete':
         _print_result(results, results.names.all_incomplete)
@@ -41,6 +41,7 @@ from six.moves import range
 
 from framework import exceptions
 from framework import status
+from framework import xvfb
 from framework.options import OPTIONS
 from framework.results import TestResult
 
@@ -324,12 +325,28 @@ class Test(object):
                                 six.iteritems(self.env))
         fullenv = {f(k): f(v) for k, v in _base}
 
+        display = xvfb.acquire()
+        for k, v in six.iteritems(xvfb.display_env(display)):
+            fullenv[f(k)] = f(v)
+
+        try:
+            self._run_process(command, fullenv)
+        finally:
+            xvfb.release(display)
+
+    def _run_process(self, command, env):
+        """Run command with env as its whole environment.
+
+        This sets self.result's out, err and returncode, and raises
+        TestRunError if the command is missing or times out.
+
+        """
         try:
             proc = subprocess.Popen(command,
                                     stdout=subprocess.PIPE,
                                     stderr=subprocess.PIPE,
                                     cwd=self.cwd,
-                                    env=fullenv,
+                                    env=env,
                                     universal_newlines=True,
                                     **_EXTRA_POPEN_ARGS)
 
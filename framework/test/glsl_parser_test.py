@@ -27,9 +27,9 @@ from __future__ import (
 import os
 import sys
 import re
-import io
 import six
 
+from framework import bundle
 from framework import exceptions
 from .base import TestIsSkip
 from .opengl import FastSkipMixin
@@ -97,9 +97,7 @@ class Parser(object):
         self.glsl_version = None
 
         try:
-            with io.open(filepath, mode='r', encoding='utf-8') as testfile:
-                testfile = testfile.read()
-                self.config = self.parse(testfile, filepath)
+            self.config = self.parse(bundle.read_text(filepath), filepath)
             self.command = self.get_command(filepath)
         except GLSLParserInternalError as e:
             raise exceptions.PiglitFatalError(
@@ -26,15 +26,23 @@ from __future__ import (
     absolute_import, division, print_function, unicode_literals
 )
 import glob
+import io
 import os
+import select
+import signal
+import subprocess
 import sys
+import tempfile
+import threading
 try:
     import simplejson as json
 except ImportError:
     import json
 
 from framework import core, options
-from .base import Test, WindowResizeMixin, ValgrindMixin, TestIsSkip
+from .base import (Test, WindowResizeMixin, ValgrindMixin, TestIsSkip,
+                   TestRunError)
+from .base import _SUPPRESS_TIMEOUT
 
 
 __all__ = [
@@ -54,8 +62,143 @@ else:
 CL_CONCURRENT = (not sys.platform.startswith('linux') or
                  glob.glob('/dev/dri/render*'))
 
+# Tests built with -DPIGLIT_BUILD_TEST_MODULES=ON can be run by
+# piglit-test-host instead of being exec'd, by setting PIGLIT_TEST_HOST to
+# anything that bool() will resolve as True.  The host only saves the
+# dynamic linking of each test; PIGLIT_TEST_HOST_PRELOAD is left to the user.
+_TEST_HOST = os.path.join(TEST_BIN_DIR, 'piglit-test-host')
+_TEST_MODULE_DIR = os.path.normpath(
+    os.path.join(TEST_BIN_DIR, '..', 'lib', 'test-modules'))
+_USE_TEST_HOST = (bool(os.environ.get('PIGLIT_TEST_HOST', False)) and
+                  os.path.exists(_TEST_HOST))
 
-class PiglitBaseTest(ValgrindMixin, Test):
+
+class _TestHost(object):
+    """A piglit-test-host process.
+
+    Each runner thread gets its own host, which runs one test at a time. See
+    tests/util/piglit-test-host.c for the protocol.
+
+    """
+    _local = threading.local()
+
+    @classmethod
+    def get(cls):
+        host = getattr(cls._local, 'host', None)
+        if host is None or host.proc.poll() is not None:
+            host = cls._local.host = cls()
+        return host
+
+    def __init__(self):
+        env = dict(os.environ)
+        env.update(options.OPTIONS.env)
+        self.proc = subprocess.Popen([_TEST_HOST],
+                                     stdin=subprocess.PIPE,
+                                     stdout=subprocess.PIPE,
+                                     env=env)
+        self._env = env
+        self._buf = b''
+
+    def _readline(self, timeout):
+        """Read a reply, or return None if timeout seconds pass first."""
+        fd = self.proc.stdout.fileno()
+        while b'\n' not in self._buf:
+            if not select.select([fd], [], [], timeout)[0]:
+                return None
+            chunk = os.read(fd, 4096)
+            if not chunk:
+                raise TestRunError('piglit-test-host exited unexpectedly\n',
+                                   'crash')
+            self._buf += chunk
+        line, self._buf = self._buf.split(b'\n', 1)
+        return line.decode('utf-8').split(' ', 1)[1]
+
+    @staticmethod
+    def _read_output(path):
+        with io.open(path, encoding='utf-8', errors='replace') as f:
+            out = f.read()
+        os.unlink(path)
+        return out
+
+    def run(self, module, command, env, cwd, timeout):
+        """Run command from module with env as its environment.
+
+        Only the variables that differ from the host's own environment are
+        sent, variables env doesn't have are left set.
+
+        Returns a (pid, returncode, out, err, timed_out) tuple, or None if the
+        request can't be expressed to the host.
+
+        """
+        env = {k: v for k, v in env.items() if self._env.get(k) != v}
+
+        out_fd, out_path = tempfile.mkstemp(prefix='piglit-out-')
+        err_fd, err_path = tempfile.mkstemp(prefix='piglit-err-')
+        os.close(out_fd)
+        os.close(err_fd)
+
+        fields = [out_path, err_path, cwd or '']
+        fields.extend('{}={}'.format(k, v) for k, v in env.items())
+        fields.append('--')
+        fields.append(module)
+        fields.extend(command)
+        if any('\t' in f or '\n' in f for f in fields):
+            os.unlink(out_path)
+            os.unlink(err_path)
+            return None
+
+        self.proc.stdin.write(('\t'.join(fields) + '\n').encode('utf-8'))
+        self.proc.stdin.flush()
+
+        pid = int(self._readline(None))
+        timed_out = False
+        returncode = self._readline(timeout)
+        if returncode is None:
+            timed_out = True
+            if pid > 0:
+                os.killpg(pid, signal.SIGKILL)
+            returncode = self._readline(None)
+
+        return (pid, int(returncode), self._read_output(out_path),
+                self._read_output(err_path), timed_out)
+
+
+class TestHostMixin(object):
+    """Mixin class that runs tests through piglit-test-host when possible.
+
+    This falls back to exec'ing the test when the host isn't enabled, when the
+    test wasn't built as a module, or when the module fails to load.
+
+    """
+    def _run_process(self, command, env):
+        module = os.path.join(_TEST_MODULE_DIR,
+                              os.path.basename(command[0]) + '.so')
+
+        if (not _USE_TEST_HOST or options.OPTIONS.valgrind or
+                os.path.dirname(command[0]) != TEST_BIN_DIR or
+                not os.path.exists(module)):
+            return super(TestHostMixin, self)._run_process(command, env)
+
+        ret = _TestHost.get().run(module, command, env, self.cwd,
+                                  None if _SUPPRESS_TIMEOUT else self.timeout)
+        if ret is None or (ret[1] == 127 and
+                           ret[3].startswith('piglit-test-host:')):
+            return super(TestHostMixin, self)._run_process(command, env)
+
+        pid, returncode, out, err, timed_out = ret
+        self.result.pid.append(pid)
+        self.result.out = out
+        self.result.err = err
+        self.result.returncode = returncode
+
+        if timed_out:
+            raise TestRunError(
+                'Test run time exceeded timeout value ({} seconds)\n'.format(
+                    self.timeout),
+                'timeout')
+
+
+class PiglitBaseTest(TestHostMixin, ValgrindMixin, Test):
     """
     PiglitTest: Run a "native" piglit test executable
 
@@ -26,10 +26,10 @@
 from __future__ import (
     absolute_import, division, print_function, unicode_literals
 )
-import io
 import os
 import re
 
+from framework import bundle
 from framework import exceptions
 from framework import status
 from .base import ReducedProcessMixin, TestIsSkip
@@ -58,6 +58,9 @@ class Parser(object):
         self._glsl_version = None
         self._glsl_es_version = None
         self.prog = None
+        self.size = None
+        self.depthbuffer = False
+        self.core = False
         self.__op = None
         self.__sl_op = None
 
@@ -67,22 +70,24 @@ class Parser(object):
         # cost. The first one looks for the start of the config block or raises
         # an exception. The second looks for the GL version or raises an
         # exception
-        with io.open(self.filename, mode='r', encoding='utf-8') as shader_file:
-            # The mock in python 3.3 doesn't support readlines(), so use
-            # read().split() as a workaround
-            lines = (l for l in shader_file.read().split('\n'))
-
-            # Find the config section
-            for line in lines:
-                # We need to find the first line of the configuration file, as
-                # soon as we do then we can move on to getting the
-                # configuration. The first line needs to be parsed by the next
-                # block.
-                if line.startswith('[require]'):
-                    break
-            else:
-                raise exceptions.PiglitFatalError(
-                    "In file {}: Config block not found".format(self.filename))
+        reqs = bundle.requirements(self.filename)
+        if reqs is not None:
+            self._from_dict(reqs)
+            return
+
+        lines = (l for l in bundle.read_text(self.filename).split('\n'))
+
+        # Find the config section
+        for line in lines:
+            # We need to find the first line of the configuration file, as
+            # soon as we do then we can move on to getting the
+            # configuration. The first line needs to be parsed by the next
+            # block.
+            if line.startswith('[require]'):
+                break
+        else:
+            raise exceptions.PiglitFatalError(
+                "In file {}: Config block not found".format(self.filename))
 
         for line in lines:
             if line.startswith('GL_') and not line.startswith('GL_MAX'):
@@ -111,6 +116,17 @@ class Parser(object):
                         self._glsl_version = float(m.group('ver'))
                     continue
 
+            if line.startswith('GL CORE'):
+                self.core = True
+
+            if line.startswith('SIZE'):
+                self.size = tuple(int(x) for x in line.split()[1:3])
+                continue
+
+            if line.startswith('depthbuffer'):
+                self.depthbuffer = True
+                continue
+
             if line.startswith('['):
                 break
 
@@ -126,6 +142,50 @@ class Parser(object):
         else:
             self.prog = 'shader_runner'
 
+    def to_dict(self):
+        """Return the parsed requirements, for framework.bundle."""
+        return {
+            'gl_required': sorted(self.gl_required),
+            'gl_version': self._gl_version,
+            'gles_version': self._gles_version,
+            'glsl_version': self._glsl_version,
+            'glsl_es_version': self._glsl_es_version,
+            'op': self.__op,
+            'sl_op': self.__sl_op,
+            'prog': self.prog,
+            'size': self.size,
+            'depthbuffer': self.depthbuffer,
+            'core': self.core,
+        }
+
+    def _from_dict(self, reqs):
+        self.gl_required = set(reqs['gl_required'])
+        self._gl_version = reqs['gl_version']
+        self._gles_version = reqs['gles_version']
+        self._glsl_version = reqs['glsl_version']
+        self._glsl_es_version = reqs['glsl_es_version']
+        self.__op = reqs['op']
+        self.__sl_op = reqs['sl_op']
+        self.prog = reqs['prog']
+        self.size = tuple(reqs['size']) if reqs.get('size') else None
+        self.depthbuffer = reqs.get('depthbuffer', False)
+        self.core = reqs.get('core', False)
+
+    @property
+    def config_signature(self):
+        """A key that is equal for tests that shader_runner can run in the
+        same context: same API, context version, window size and depth
+        buffer.
+        """
+        return (self.prog,
+                self.core,
+                self._gles_version or 0,
+                self._gl_version or 0,
+                self._glsl_version or 0,
+                self._glsl_es_version or 0,
+                self.size or (0, 0),
+                self.depthbuffer)
+
     # FIXME: All of these properties are a work-around for the fact that the
     # FastSkipMixin assumes that operations are always > or >=
 
@@ -206,9 +266,19 @@ class MultiShaderTest(ReducedProcessMixin, PiglitBaseTest):
         # Walk each subtest, and either add it to the list of tests to run, or
         # determine it is skip, and set the result of that test in the subtests
         # dictionary to skip without adding it to the list of tests to run.
+        # shader_runner has to re-exec itself whenever the next test needs a
+        # different context, so group tests with the same requirements. The
+        # sort is stable, and results are reported per file name, so only
+        # the run order changes.
+        parsers = []
         for each in filenames:
             parser = Parser(each)
             parser.parse()
+            parsers.append(parser)
+        parsers.sort(key=lambda p: p.config_signature)
+
+        for parser in parsers:
+            each = parser.filename
             subtest = os.path.basename(os.path.splitext(each)[0]).lower()
 
             if prog is not None:
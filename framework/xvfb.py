@@ -0,0 +1,176 @@
+# Copyright © 2026 The Piglit project
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice (including the next
+# paragraph) shall be included in all copies or substantial portions of the
+# Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+# IN THE SOFTWARE.
+
+"""Spread concurrently running tests over several Xvfb servers.
+
+A single X server serialises window creation, mapping and expose events, so
+with many tests running at once it, rather than the driver, limits how fast
+the X11 tests run.  The broker owns a number of Xvfb servers and hands each
+test the DISPLAY of the server currently running the fewest tests.  The
+frameworks need no help to use it, they connect to whatever DISPLAY names.
+
+"""
+
+from __future__ import (
+    absolute_import, division, print_function, unicode_literals
+)
+import os
+import subprocess
+import threading
+
+import six
+
+from framework import exceptions
+
+__all__ = [
+    'XvfbBroker',
+    'acquire',
+    'display_env',
+    'release',
+    'start',
+    'stop',
+]
+
+_BROKER = None
+
+
+class XvfbBroker(object):
+    """Owns a set of Xvfb servers and balances tests between them."""
+
+    def __init__(self, count, xvfb='Xvfb'):
+        self._lock = threading.Lock()
+        self._procs = []
+        self._users = {}
+
+        try:
+            for _ in range(count):
+                proc, display = self._start_server(xvfb)
+                self._procs.append(proc)
+                self._users[display] = 0
+        except Exception:
+            self.stop()
+            raise
+
+    @staticmethod
+    def _start_server(xvfb):
+        """Start an Xvfb on a free display, return the process and DISPLAY.
+
+        Xvfb picks the display number itself and writes it to -displayfd
+        once it accepts connections, so there is neither a race for the
+        number nor a need to poll for the socket.
+
+        """
+        read, write = os.pipe()
+        if six.PY3:
+            kwargs = {'pass_fds': (write,)}
+        else:
+            kwargs = {'close_fds': False}
+
+        try:
+            with open(os.devnull, 'w') as devnull:
+                proc = subprocess.Popen(
+                    [xvfb, '-displayfd', str(write), '-nolisten', 'tcp',
+                     '-noreset', '-screen', '0', '1280x1024x24'],
+                    stdout=devnull, stderr=devnull, **kwargs)
+        except OSError as e:
+            os.close(read)
+            os.close(write)
+            raise exceptions.PiglitFatalError(
+                'Cannot start {}: {}'.format(xvfb, e))
+        os.close(write)
+
+        with os.fdopen(read) as f:
+            number = f.readline().strip()
+        if not number:
+            proc.wait()
+            raise exceptions.PiglitFatalError(
+                '{} exited with status {} before opening a display'.format(
+                    xvfb, proc.returncode))
+
+        return proc, ':' + number
+
+    @property
+    def displays(self):
+        return sorted(self._users)
+
+    def acquire(self):
+        """Return the DISPLAY of the least busy server."""
+        with self._lock:
+            display = min(self._users, key=lambda d: (self._users[d], d))
+            self._users[display] += 1
+            return display
+
+    def release(self, display):
+        with self._lock:
+            self._users[display] -= 1
+
+    def stop(self):
+        for proc in self._procs:
+            proc.terminate()
+        for proc in self._procs:
+            proc.wait()
+        self._procs = []
+        self._users = {}
+
+
+def start(count):
+    """Start the broker with count servers, if count is nonzero."""
+    global _BROKER  # pylint: disable=global-statement
+    assert _BROKER is None
+    if count:
+        _BROKER = XvfbBroker(count)
+
+
+def stop():
+    global _BROKER  # pylint: disable=global-statement
+    if _BROKER is not None:
+        _BROKER.stop()
+        _BROKER = None
+
+
+def acquire():
+    """Return the DISPLAY a test should use, or None to leave it alone.
+
+    Every display returned must be given back with release().
+
+    """
+    if _BROKER is None:
+        return None
+    return _BROKER.acquire()
+
+
+def release(display):
+    if display is not None:
+        _BROKER.release(display)
+
+
+def display_env(display):
+    """Return the environment variables for running on display.
+
+    Besides DISPLAY this sets PIGLIT_XVFB, which is part of the key of the
+    driver capability snapshots in PIGLIT_CAPS_DIR: an Xvfb usually has a
+    different GL driver than the server DISPLAY names otherwise, but all
+    the broker's servers have the same one.
+
+    """
+    if display is None:
+        return {}
+    return {'DISPLAY': display, 'PIGLIT_XVFB': '1'}
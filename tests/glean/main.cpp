@@ -32,6 +32,7 @@
 // main.cpp:  main program for Glean
 
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <string>
@@ -71,6 +72,10 @@ main(int argc, char* argv[]) {
 
 	bool listTestsMode = false;
 
+#	if defined(__X11__)
+	o.program = argv[0];
+#	endif
+
 	for (int i = 1; i < argc; ++i) {
 		if (!strcmp(argv[i], "--help")) {
 			usage(argv[0]);
@@ -92,6 +97,20 @@ main(int argc, char* argv[]) {
 			selectTests(o, allTestNames, argc, argv, i);
 		} else if (!strcmp(argv[i], "--listtests")) {
 			listTestsMode = true;
+#	    if defined(__X11__)
+		} else if (!strcmp(argv[i], "-j")
+		    || !strcmp(argv[i], "--jobs")) {
+			++i;
+			int jobs = atoi(mandatoryArg(argc, argv, i));
+			if (jobs < 1)
+				usage(argv[0]);
+			o.jobs = jobs;
+		} else if (!strcmp(argv[i], "--config-id")) {
+			++i;
+			o.childMode = true;
+			o.childVisID = strtoul(mandatoryArg(argc, argv, i),
+					       NULL, 0);
+#	    endif
 #	    if defined(__X11__)
 		} else if (!strcmp(argv[i], "-display")
 		    || !strcmp(argv[i], "--display")) {
@@ -274,6 +293,10 @@ usage(char* command) {
 "       --listtests                # list test names and exit\n"
 "       --help                     # display usage information\n"
 #if defined(__X11__)
+"       (-j|--jobs) N              # test up to N surface configs at once,\n"
+"                                  # each in its own process\n"
+"       --config-id ID             # test only the config with visual ID,\n"
+"                                  # used by --jobs\n"
 "       -display X11-display-name  # select X11 display to use\n"
 "           (or --display)\n"
 #elif defined(__WIN__)
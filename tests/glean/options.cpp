@@ -47,6 +47,7 @@ Options::Options() {
 	selectedTests.resize(0);
 	overwrite = false;
 	quick = false;
+	jobs = 1;
 #   if defined(__X11__)
 	{
 	char* display = getenv("DISPLAY");
@@ -55,6 +56,8 @@ Options::Options() {
 	else
 		dpyName = ":0";
 	}
+	childMode = false;
+	childVisID = 0;
 #   elif defined(__WIN__)
 #   endif
 } // Options::Options()
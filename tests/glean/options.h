@@ -75,9 +75,20 @@ class Options {
 
 	bool quick;		// run fewer/quicker tests when possible
 
+	unsigned int jobs;	// Max number of drawing surface configs
+				// tested at once, each in its own process.
+				// 1 tests them one after the other.
+
 #if defined(__X11__)
 	string dpyName;		// Name of the X11 display providing the
 				// OpenGL implementation to be tested.
+
+	string program;		// argv[0], run again for each config
+				// when jobs > 1.
+
+	bool childMode;		// Test only the config with visual ID
+	unsigned long childVisID;// childVisID, for a parent running with
+				// jobs > 1.
 #elif defined(__WIN__)
 #endif
 
@@ -278,6 +278,15 @@ public:
 		if (hasRun)
 			return; // no multiple invocations
 
+#		if defined(__X11__)
+		if (environment.options.childMode) {
+			env = &environment;
+			runChildConfig();
+			hasRun = true;
+			return;
+		}
+#		endif
+
 		// Invoke the prerequisite tests, if any:
 		for (Test** t = prereqs; t != 0 && *t != 0; ++t)
 			(*t)->run(environment);
@@ -294,48 +303,27 @@ public:
 			if (env->options.quick)
 				testOne = true;
 
+#			if defined(__X11__)
+			if (!testOne && env->options.jobs > 1) {
+				vector<unsigned long> visIDs;
+				for (size_t i = 0; i < configs.size(); ++i)
+					if (configs[i]->samples == 0)
+						visIDs.push_back(
+							configs[i]->visID);
+				if (visIDs.size() > 1) {
+					runConfigProcesses(visIDs);
+					configs.clear();
+				}
+			}
+#			endif
+
 			// Test each config
 			for (vector<DrawingSurfaceConfig*>::const_iterator
 				     p = configs.begin();
 			     p < configs.end();
 			     ++p) {
-				// Many tests do not adjust their expectations
-				// for multisampling and hence incorrectly
-				// fail.
-				if ((*p)->samples > 0)
-					continue;
-
-				Window w(ws, **p, fWidth, fHeight);
-				RenderingContext rc(ws, **p);
-				if (!ws.makeCurrent(rc, w)) {
-					// XXX need to throw exception here
-				}
-
-				// Make sure glew is initialized so we can call
-				// GL functions safely.
-				piglit_dispatch_default_init(PIGLIT_DISPATCH_GL);
-
-				// Check if test is applicable to this context
-				if (!isApplicable())
-					continue;
-
-				// Check for all prerequisite extensions.  Note
-				// that this must be done after the rendering
-				// context has been created and made current!
-				if (!GLUtils::haveExtensions(extensions))
-					continue;
-
-				// Create a result object and run the test:
-				ResultType* r = new ResultType();
-				r->config = *p;
-				runOne(*r, w);
-				logOne(*r);
-
-				// Save the result
-				results.push_back(r);
-
 				// if testOne, skip remaining surface configs
-				if (testOne)
+				if (runConfig(ws, **p) && testOne)
 					break;
 			}
 		}
@@ -356,6 +344,72 @@ public:
 		hasRun = true;	// Note that we've completed the run
 	}
 
+	// Run the test on one config, return whether it was applicable.
+	bool runConfig(WindowSystem& ws, DrawingSurfaceConfig& config) {
+		// Many tests do not adjust their expectations for
+		// multisampling and hence incorrectly fail.
+		if (config.samples > 0)
+			return false;
+
+		Window w(ws, config, fWidth, fHeight);
+		RenderingContext rc(ws, config);
+		if (!ws.makeCurrent(rc, w)) {
+			// XXX need to throw exception here
+		}
+
+		// Make sure glew is initialized so we can call
+		// GL functions safely.
+		piglit_dispatch_default_init(PIGLIT_DISPATCH_GL);
+
+		// Check if test is applicable to this context
+		if (!isApplicable())
+			return false;
+
+		// Check for all prerequisite extensions.  Note that this
+		// must be done after the rendering context has been created
+		// and made current!
+		if (!GLUtils::haveExtensions(extensions))
+			return false;
+
+		// Create a result object and run the test:
+		ResultType* r = new ResultType();
+		r->config = &config;
+		runOne(*r, w);
+		logOne(*r);
+
+		// Save the result
+		results.push_back(r);
+		return true;
+	}
+
+#   if defined(__X11__)
+	// Run the test on the config --config-id names, for a parent in
+	// runConfigProcesses().  Only the result is logged, the parent
+	// logs the rest.
+	void runChildConfig() {
+		WindowSystem& ws = env->winSys;
+		DrawingSurfaceConfig* config = 0;
+
+		for (size_t j = 0; j < ws.surfConfigs.size(); ++j)
+			if (ws.surfConfigs[j]->visID ==
+			    env->options.childVisID)
+				config = ws.surfConfigs[j];
+		if (!config) {
+			env->log << name << ":  FAIL  visual 0x" << hex
+				 << env->options.childVisID << dec
+				 << " not found\n";
+			return;
+		}
+
+		try {
+			runConfig(ws, *config);
+		}
+		catch (RenderingContext::Error) {
+			env->log << "Could not create a rendering context\n";
+		}
+	}
+#   endif
+
 	virtual void logPassFail(ResultType& r) {
 		env->log << name << (r.pass ? ":  PASS ": ":  FAIL ");
 	}
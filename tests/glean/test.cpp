@@ -33,6 +33,11 @@
 #ifdef __UNIX__
 #include <unistd.h>
 #endif
+#if defined(__X11__)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <cstdio>
+#endif
 
 #include <iostream>
 #include "dsconfig.h"
@@ -80,4 +85,93 @@ Test::Test(const char* testName, const char *descrip, Test** thePrereqs):
 Test::~Test() {
 } // Test::~Test
 
+#if defined(__X11__)
+///////////////////////////////////////////////////////////////////////////////
+// runConfigProcesses:  run a test on several configs in parallel processes
+///////////////////////////////////////////////////////////////////////////////
+void
+Test::runConfigProcesses(const vector<unsigned long>& visIDs) {
+	const size_t count = visIDs.size();
+	const Options& o = env->options;
+	vector<FILE*> out(count, (FILE*) NULL);
+	vector<pid_t> pids(count, (pid_t) -1);
+	vector<int> status(count, 0);
+	size_t started = 0, reaped = 0;
+
+	// Everything but the config is the same for all the children.
+	vector<string> args;
+	args.push_back(o.program);
+	args.push_back("-t");
+	args.push_back(string("+") + name);
+	args.push_back("-display");
+	args.push_back(o.dpyName);
+	for (int v = 0; v < o.verbosity; ++v)
+		args.push_back("-v");
+	if (o.quick)
+		args.push_back("--quick");
+	args.push_back("--config-id");
+	args.push_back("");
+
+	env->log.flush();
+	fflush(stdout);
+
+	while (reaped < count) {
+		if (started < count && started - reaped < o.jobs) {
+			size_t i = started++;
+			char id[32];
+
+			snprintf(id, sizeof(id), "0x%lx", visIDs[i]);
+			args.back() = id;
+
+			vector<char*> argv;
+			for (size_t a = 0; a < args.size(); ++a)
+				argv.push_back(const_cast<char*>(
+					args[a].c_str()));
+			argv.push_back(NULL);
+
+			out[i] = tmpfile();
+			if (out[i])
+				pids[i] = fork();
+			if (pids[i] == 0) {
+				dup2(fileno(out[i]), STDOUT_FILENO);
+				execvp(argv[0], &argv[0]);
+				_exit(127);
+			}
+			continue;
+		}
+
+		// The output is replayed in order anyway, so wait for the
+		// oldest child first.
+		if (pids[reaped] > 0 &&
+		    waitpid(pids[reaped], &status[reaped], 0) < 0)
+			pids[reaped] = -1;
+		++reaped;
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		if (out[i]) {
+			char buf[4096];
+			size_t n;
+
+			rewind(out[i]);
+			while ((n = fread(buf, 1, sizeof(buf), out[i])) > 0)
+				env->log.write(buf, n);
+			fclose(out[i]);
+		}
+
+		if (pids[i] < 0)
+			env->log << name << ":  FAIL  could not run a "
+				 << "process for config " << i << '\n';
+		else if (WIFSIGNALED(status[i]))
+			env->log << name << ":  FAIL  process for config "
+				 << i << " killed by signal "
+				 << WTERMSIG(status[i]) << '\n';
+		else if (WEXITSTATUS(status[i]) != 0)
+			env->log << name << ":  FAIL  process for config "
+				 << i << " exited with status "
+				 << WEXITSTATUS(status[i]) << '\n';
+	}
+} // Test::runConfigProcesses
+#endif
+
 } // namespace GLEAN
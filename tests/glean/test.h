@@ -98,6 +98,16 @@ class Test {
 
 	virtual void run(Environment& env) = 0;	// Run test, save results.
 
+#   if defined(__X11__)
+	// Run this test on each of the configs with the given visual IDs,
+	// by running glean again with --config-id for each of them, with
+	// at most env->options.jobs processes at once.  glean is re-executed
+	// rather than forked as the parent has already talked to GLX.  The
+	// output is logged in order, as if they had run one after the other,
+	// and a process that doesn't exit normally is logged as a FAIL.
+	void runConfigProcesses(const vector<unsigned long>& visIDs);
+#   endif
+
 	// Exceptions:
 	struct Error { };	// Base class for all exceptions.
 
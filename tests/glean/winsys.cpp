@@ -32,17 +32,109 @@
 // winsys.cpp:  implementation of window-system services class
 
 #include <iostream>
+#if defined(__X11__)
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#endif
 #include "options.h"
 #include "winsys.h"
 #include "dsconfig.h"
 #include "dsfilt.h"
 #include "dsurf.h"
 #include "rc.h"
+#if defined(__X11__)
+#include "piglit-caps.h"
+#endif
 
 using namespace std;
 
 namespace GLEAN {
 
+#if defined(__X11__)
+///////////////////////////////////////////////////////////////////////////////
+// Cache of the OpenGL-capable configs, so that each run doesn't have to
+// query every attribute of every visual.  It lives next to the driver
+// capability snapshots in PIGLIT_CAPS_DIR (see piglit-caps.h), whose key
+// covers the driver.  The first line identifies the X server and GLX
+// implementation, because visual IDs are only meaningful for those; the
+// following lines hold one canonical config description each.
+///////////////////////////////////////////////////////////////////////////////
+static string
+configCacheHeader(Display* dpy) {
+	int screen = DefaultScreen(dpy);
+	const char* glxVendor = glXQueryServerString(dpy, screen, GLX_VENDOR);
+	const char* glxVersion = glXQueryServerString(dpy, screen, GLX_VERSION);
+	ostringstream s;
+
+	s << "glean configs 1"
+	  << " server " << ServerVendor(dpy) << ' ' << VendorRelease(dpy)
+	  << " screen " << screen
+	  << " glx " << (glxVendor ? glxVendor : "") << ' '
+	  << (glxVersion ? glxVersion : "");
+	return s.str();
+}
+
+static bool
+loadConfigCache(Display* dpy, XVisualInfo* vip, int n,
+    vector<DrawingSurfaceConfig*>& configs) {
+	char* path = piglit_caps_path("glean");
+	if (!path)
+		return false;
+	ifstream f(path);
+	free(path);
+
+	string line;
+	if (!getline(f, line) || line != configCacheHeader(dpy))
+		return false;
+
+	try {
+		while (getline(f, line)) {
+			DrawingSurfaceConfig* c = new DrawingSurfaceConfig(line);
+			configs.push_back(c);
+
+			c->vi = 0;
+			for (int i = 0; i < n; ++i)
+				if (vip[i].visualid == c->visID)
+					c->vi = &vip[i];
+			if (!c->vi)
+				throw DrawingSurfaceConfig::Error();
+		}
+	}
+	catch (DrawingSurfaceConfig::Error) {
+		for (size_t i = 0; i < configs.size(); ++i)
+			delete configs[i];
+		configs.clear();
+		return false;
+	}
+
+	return !configs.empty();
+}
+
+static void
+saveConfigCache(Display* dpy, vector<DrawingSurfaceConfig*>& configs) {
+	char* path = piglit_caps_path("glean");
+	if (!path)
+		return;
+
+	// Write a private file and rename it into place, so that
+	// concurrent runs never read a partial cache.
+	ostringstream tmp;
+	tmp << path << ".tmp." << getpid();
+	{
+		ofstream f(tmp.str().c_str());
+		f << configCacheHeader(dpy) << '\n';
+		for (size_t i = 0; i < configs.size(); ++i)
+			f << configs[i]->canonicalDescription() << '\n';
+	}
+	if (rename(tmp.str().c_str(), path) != 0)
+		remove(tmp.str().c_str());
+	free(path);
+}
+#endif
+
 
 ///////////////////////////////////////////////////////////////////////////////
 // Constructors
@@ -72,11 +164,14 @@ WindowSystem::WindowSystem(Options& o) {
 	// Construct a vector of DrawingSurfaceConfigs corresponding to the
 	// XVisualInfo structures that indicate they support OpenGL:
 	vector<DrawingSurfaceConfig*> glxv;
-	for (int i = 0; i < n; ++i) {
-		int supportsOpenGL;
-		glXGetConfig(dpy, &vip[i], GLX_USE_GL, &supportsOpenGL);
-		if (supportsOpenGL)
-			glxv.push_back(new DrawingSurfaceConfig (dpy, &vip[i]));
+	if (!loadConfigCache(dpy, vip, n, glxv)) {
+		for (int i = 0; i < n; ++i) {
+			int supportsOpenGL;
+			glXGetConfig(dpy, &vip[i], GLX_USE_GL, &supportsOpenGL);
+			if (supportsOpenGL)
+				glxv.push_back(new DrawingSurfaceConfig (dpy, &vip[i]));
+		}
+		saveConfigCache(dpy, glxv);
 	}
 
 	// Filter the basic list of DrawingSurfaceConfigs according to
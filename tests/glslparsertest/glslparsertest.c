@@ -34,9 +34,12 @@
 #include <errno.h>
 
 #include "piglit-util-gl.h"
+#include "piglit-caps.h"
 
 static unsigned parse_glsl_version_number(const char *str);
 static int process_options(int argc, char **argv);
+static bool caps_predict_skip(const struct piglit_gl_test_config *config,
+			      int argc, char **argv);
 
 PIGLIT_GL_TEST_CONFIG_BEGIN
 
@@ -87,6 +90,9 @@ PIGLIT_GL_TEST_CONFIG_BEGIN
 	config.window_height = 100;
 	config.window_visual = PIGLIT_GL_VISUAL_DOUBLE | PIGLIT_GL_VISUAL_RGB;
 
+	if (argc > 2 && caps_predict_skip(&config, argc, argv))
+		piglit_report_result(PIGLIT_SKIP);
+
 PIGLIT_GL_TEST_CONFIG_END
 
 static char *filename;
@@ -490,6 +496,100 @@ check_version(unsigned glsl_version)
 }
 
 
+/**
+ * Check what piglit_init() and test() require against the capability
+ * snapshot of one context.  Returns false, after saying why, if a
+ * requirement is known to be unmet.
+ */
+static bool
+caps_meet_requirements(const struct piglit_caps *caps, int argc, char **argv)
+{
+	const char *filename = argv[1];
+	const char *stage = filename + strlen(filename) - 4;
+	unsigned version = argc > 3 ? parse_glsl_version_number(argv[3]) : 110;
+	int i;
+
+	if (caps->gl_version < 20 && !caps->es &&
+	    !piglit_caps_has_extension(caps, "GL_ARB_shader_objects")) {
+		printf("The %s snapshot lacks OpenGL 2.0\n", caps->profile);
+		return false;
+	}
+
+	if (!caps->es && version == 100) {
+		if (!piglit_caps_has_extension(caps, "GL_ARB_ES2_compatibility"))
+			return false;
+	} else if (!caps->es && version == 300) {
+		if (!piglit_caps_has_extension(caps, "GL_ARB_ES3_compatibility"))
+			return false;
+	} else if (!caps->es && version == 310) {
+		if (!piglit_caps_has_extension(caps, "GL_ARB_ES3_1_compatibility"))
+			return false;
+	} else if (!caps->es && version == 320) {
+		if (!piglit_caps_has_extension(caps, "GL_ARB_ES3_2_compatibility"))
+			return false;
+	} else if (caps->glsl_version < version) {
+		printf("The %s snapshot has GLSL version %u.%u, but requested "
+		       "version %u.%u is required\n", caps->profile,
+		       caps->glsl_version / 100, caps->glsl_version % 100,
+		       version / 100, version % 100);
+		return false;
+	}
+
+	for (i = 4; i < argc; i++) {
+		const bool negate = argv[i][0] == '!';
+
+		if (piglit_caps_has_extension(caps, argv[i] + negate) == negate) {
+			printf("The %s snapshot %s %s\n", caps->profile,
+			       negate ? "has" : "lacks", argv[i] + negate);
+			return false;
+		}
+	}
+
+	if (strcmp(stage, "tesc") == 0 || strcmp(stage, "tese") == 0) {
+		if (caps->gl_version < (caps->es ? 32 : 40) &&
+		    !piglit_caps_has_extension(caps, caps->es ?
+					       "GL_OES_tessellation_shader" :
+					       "GL_ARB_tessellation_shader"))
+			return false;
+	} else if (strcmp(stage, "comp") == 0) {
+		if (caps->gl_version < (caps->es ? 31 : 43) &&
+		    (caps->es ||
+		     !piglit_caps_has_extension(caps, "GL_ARB_compute_shader")))
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Decide from the capability snapshots in PIGLIT_CAPS_DIR whether the test
+ * would skip on every context the framework may create for \p config, so
+ * that it can skip without creating one.  Returns false whenever a
+ * snapshot is missing.
+ */
+static bool
+caps_predict_skip(const struct piglit_gl_test_config *config,
+		  int argc, char **argv)
+{
+	struct piglit_caps_candidate candidates[2];
+	int count, i;
+
+	if (strlen(argv[1]) < 5)
+		return false;
+
+	count = piglit_caps_for_config(config, candidates);
+	if (count < 0)
+		return false;
+
+	for (i = 0; i < count; i++) {
+		if (caps_meet_requirements(candidates[i].caps, argc, argv))
+			return false;
+	}
+
+	return true;
+}
+
+
 void
 piglit_init(int argc, char**argv)
 {
@@ -58,16 +58,87 @@ hiz_probe_color_buffer(const float *expected_colors[])
 	hiz_probe_common(piglit_probe_rect_rgb, expected_colors);
 }
 
+/**
+ * Check the same nine rectangles as hiz_probe_common() with a single
+ * readback of the whole depth or stencil buffer, as \p format and
+ * GL_UNSIGNED_INT, comparing in integer space.
+ */
+static bool
+hiz_probe_uint_buffer(GLenum format, const GLuint expected[9],
+		      GLuint tolerance)
+{
+	const float dx = piglit_width / 9.0;
+	const float dy = piglit_height / 9.0;
+	GLuint *pixels = malloc(piglit_width * piglit_height * sizeof(GLuint));
+	bool pass = true;
+	int ix, iy;
+
+	glReadPixels(0, 0, piglit_width, piglit_height, format,
+		     GL_UNSIGNED_INT, pixels);
+
+	for (iy = 0; iy < 3; ++iy) for (ix = 0; ix < 3; ++ix) {
+		const int x0 = (3 * ix + 1) * dx;
+		const int y0 = (3 * iy + 1) * dy;
+		const GLuint e = expected[3 * (2 - iy) + ix];
+		bool rect_pass = true;
+		int x, y;
+
+		/* Like the rect probes, report the first failure per rect. */
+		for (y = y0; y < y0 + (int) dy && rect_pass; ++y) {
+			const GLuint *row = &pixels[y * piglit_width];
+
+			for (x = x0; x < x0 + (int) dx; ++x) {
+				const GLuint p = row[x];
+				const GLuint diff = p > e ? p - e : e - p;
+
+				/* As strict as the rect probes: depth
+				 * must be within, not at, the tolerance,
+				 * and stencil (tolerance 0) must match.
+				 */
+				if (diff == 0 || diff < tolerance)
+					continue;
+
+				if (format == GL_DEPTH_COMPONENT) {
+					printf("Probe depth at (%i,%i)\n", x, y);
+					printf("  Expected: %f\n",
+					       e / 4294967295.0);
+					printf("  Observed: %f\n",
+					       p / 4294967295.0);
+				} else {
+					printf("Probe stencil at (%i, %i)\n",
+					       x, y);
+					printf("  Expected: %u\n", e);
+					printf("  Observed: %u\n", p);
+				}
+				rect_pass = pass = false;
+				break;
+			}
+		}
+	}
+
+	free(pixels);
+	return pass;
+}
+
 bool
 hiz_probe_depth_buffer(const float expected_depths[])
 {
-	hiz_probe_common(piglit_probe_rect_depth, expected_depths);
+	GLuint expected[9];
+	int i;
+
+	/* GL_UNSIGNED_INT depth reads are normalized to the full 32 bits. */
+	for (i = 0; i < 9; ++i)
+		expected[i] = CLAMP(expected_depths[i], 0.0, 1.0) *
+			      4294967295.0;
+
+	return hiz_probe_uint_buffer(GL_DEPTH_COMPONENT, expected,
+				     0.01 * 4294967295.0);
 }
 
 bool
 hiz_probe_stencil_buffer(const unsigned expected_stencil[])
 {
-	hiz_probe_common(piglit_probe_rect_stencil, expected_stencil);
+	return hiz_probe_uint_buffer(GL_STENCIL_INDEX, expected_stencil, 0);
 }
 
 
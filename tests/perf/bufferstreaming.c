@@ -0,0 +1,421 @@
+/*
+ * Copyright © 2026 The Piglit project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * Measure the cost of streaming vertex and uniform data into buffer
+ * objects once per draw call, with the usual update strategies:
+ * glBufferSubData, orphaning with glBufferData, glMapBufferRange with the
+ * INVALIDATE and UNSYNCHRONIZED bits, and persistent mappings
+ * (GL_ARB_buffer_storage) that are either coherent or explicitly flushed.
+ *
+ * All vertices are at the origin so that every primitive is culled, and
+ * only the update + draw overhead is measured.
+ */
+
+#include "common.h"
+#include <stdbool.h>
+#include "piglit-util-gl.h"
+
+PIGLIT_GL_TEST_CONFIG_BEGIN
+
+	config.supports_gl_compat_version = 0;
+	config.supports_gl_core_version = 32;
+
+	puts("Buffer streaming, draw calls per second:");
+
+	config.window_visual = PIGLIT_GL_VISUAL_RGBA | PIGLIT_GL_VISUAL_DOUBLE;
+
+PIGLIT_GL_TEST_CONFIG_END
+
+#define RING_SIZE	(4 * 1024 * 1024)
+#define NUM_SEGMENTS	4
+
+enum strategy {
+	BUFFER_SUB_DATA,
+	ORPHAN,
+	MAP_INVALIDATE_BUFFER,
+	MAP_INVALIDATE_RANGE,
+	MAP_UNSYNCHRONIZED,
+	PERSISTENT_COHERENT,
+	PERSISTENT_FLUSH,
+};
+
+static const char *strategy_names[] = {
+	"BufferSubData",
+	"BufferData orphan",
+	"MapBufferRange INVALIDATE_BUFFER",
+	"MapBufferRange INVALIDATE_RANGE",
+	"MapBufferRange UNSYNCHRONIZED",
+	"persistent coherent",
+	"persistent explicit flush",
+};
+
+static GLuint vs_prog, ubo_progs[4];
+static GLint ubo_alignment;
+static bool has_buffer_storage;
+
+/* State of the stream being measured. */
+static GLenum target;
+static GLuint prog;
+static GLuint buf;
+static unsigned stream_size;
+static unsigned stream_stride;
+static unsigned offset;
+static char *data;
+static char *persistent_map;
+static GLsync fences[NUM_SEGMENTS];
+
+static GLuint
+build_ubo_program(unsigned num_vec4)
+{
+	char vs[512];
+	GLuint p;
+
+	snprintf(vs, sizeof(vs),
+		 "#version 140\n"
+		 "uniform ub { vec4 v[%u]; };\n"
+		 "void main() {\n"
+		 "	gl_Position = v[gl_VertexID %% %u];\n"
+		 "}\n", num_vec4, num_vec4);
+
+	p = piglit_build_simple_program(vs,
+		"#version 140\n"
+		"out vec4 color;\n"
+		"void main() { color = vec4(1.0); }\n");
+	glUniformBlockBinding(p, glGetUniformBlockIndex(p, "ub"), 0);
+	return p;
+}
+
+void
+piglit_init(int argc, char **argv)
+{
+	static const unsigned ubo_sizes[] = { 64, 1024, 16384 };
+	GLuint vao;
+	unsigned i;
+
+	piglit_require_gl_version(31);
+
+	has_buffer_storage = piglit_get_gl_version() >= 44 ||
+		piglit_is_extension_supported("GL_ARB_buffer_storage");
+
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &ubo_alignment);
+
+	glGenVertexArrays(1, &vao);
+	glBindVertexArray(vao);
+
+	vs_prog = piglit_build_simple_program(
+		"#version 140\n"
+		"in vec4 v;\n"
+		"void main() { gl_Position = v; }\n",
+		"#version 140\n"
+		"out vec4 color;\n"
+		"void main() { color = vec4(1.0); }\n");
+	glBindAttribLocation(vs_prog, 0, "v");
+	glLinkProgram(vs_prog);
+
+	for (i = 0; i < ARRAY_SIZE(ubo_sizes); i++)
+		ubo_progs[i] = build_ubo_program(ubo_sizes[i] / 16);
+
+	/* Zeroed data: every vertex lands on the origin. */
+	data = calloc(1, 256 * 1024);
+}
+
+/**
+ * Return the ring offset for the next update.  Persistent mappings fence
+ * each segment of the ring and wait for it before overwriting it again.
+ */
+static unsigned
+next_offset(bool *wrapped)
+{
+	unsigned segment_size = RING_SIZE / NUM_SEGMENTS;
+	unsigned old_segment = offset / segment_size;
+	unsigned new_segment;
+
+	offset += stream_stride;
+	*wrapped = offset + stream_size > RING_SIZE;
+	if (*wrapped)
+		offset = 0;
+
+	new_segment = offset / segment_size;
+	if (persistent_map && new_segment != old_segment) {
+		fences[old_segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE,
+						  0);
+		if (fences[new_segment]) {
+			glClientWaitSync(fences[new_segment],
+					 GL_SYNC_FLUSH_COMMANDS_BIT,
+					 GL_TIMEOUT_IGNORED);
+			glDeleteSync(fences[new_segment]);
+			fences[new_segment] = NULL;
+		}
+	}
+
+	return offset;
+}
+
+static void
+draw_stream(unsigned draw_offset)
+{
+	if (target == GL_ARRAY_BUFFER) {
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0,
+				      (void *)(uintptr_t) draw_offset);
+		glDrawArrays(GL_TRIANGLES, 0, stream_size / 16 / 3 * 3);
+	} else {
+		glBindBufferRange(GL_UNIFORM_BUFFER, 0, buf, draw_offset,
+				  stream_size);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+	}
+}
+
+static void
+stream_buffer_sub_data(unsigned count)
+{
+	unsigned i;
+	bool wrapped;
+
+	for (i = 0; i < count; i++) {
+		unsigned off = next_offset(&wrapped);
+
+		glBufferSubData(target, off, stream_size, data);
+		draw_stream(off);
+	}
+}
+
+static void
+stream_orphan(unsigned count)
+{
+	unsigned i;
+
+	for (i = 0; i < count; i++) {
+		glBufferData(target, stream_size, NULL, GL_STREAM_DRAW);
+		glBufferSubData(target, 0, stream_size, data);
+		draw_stream(0);
+	}
+}
+
+static void
+stream_map_invalidate_buffer(unsigned count)
+{
+	unsigned i;
+
+	for (i = 0; i < count; i++) {
+		void *ptr = glMapBufferRange(target, 0, stream_size,
+					     GL_MAP_WRITE_BIT |
+					     GL_MAP_INVALIDATE_BUFFER_BIT);
+		memcpy(ptr, data, stream_size);
+		glUnmapBuffer(target);
+		draw_stream(0);
+	}
+}
+
+static void
+stream_map_invalidate_range(unsigned count)
+{
+	unsigned i;
+	bool wrapped;
+
+	for (i = 0; i < count; i++) {
+		unsigned off = next_offset(&wrapped);
+		void *ptr = glMapBufferRange(target, off, stream_size,
+					     GL_MAP_WRITE_BIT |
+					     GL_MAP_INVALIDATE_RANGE_BIT);
+		memcpy(ptr, data, stream_size);
+		glUnmapBuffer(target);
+		draw_stream(off);
+	}
+}
+
+static void
+stream_map_unsynchronized(unsigned count)
+{
+	unsigned i;
+	bool wrapped;
+
+	for (i = 0; i < count; i++) {
+		unsigned off = next_offset(&wrapped);
+		/* The classic ring: orphan on wrap-around, otherwise
+		 * append without synchronization.
+		 */
+		GLbitfield access = GL_MAP_WRITE_BIT |
+			(wrapped ? GL_MAP_INVALIDATE_BUFFER_BIT :
+				   GL_MAP_UNSYNCHRONIZED_BIT |
+				   GL_MAP_INVALIDATE_RANGE_BIT);
+		void *ptr = glMapBufferRange(target, off, stream_size, access);
+
+		memcpy(ptr, data, stream_size);
+		glUnmapBuffer(target);
+		draw_stream(off);
+	}
+}
+
+static void
+stream_persistent_coherent(unsigned count)
+{
+	unsigned i;
+	bool wrapped;
+
+	for (i = 0; i < count; i++) {
+		unsigned off = next_offset(&wrapped);
+
+		memcpy(persistent_map + off, data, stream_size);
+		draw_stream(off);
+	}
+}
+
+static void
+stream_persistent_flush(unsigned count)
+{
+	unsigned i;
+	bool wrapped;
+
+	for (i = 0; i < count; i++) {
+		unsigned off = next_offset(&wrapped);
+
+		memcpy(persistent_map + off, data, stream_size);
+		glFlushMappedBufferRange(target, off, stream_size);
+		draw_stream(off);
+	}
+}
+
+static const perf_rate_func strategy_funcs[] = {
+	stream_buffer_sub_data,
+	stream_orphan,
+	stream_map_invalidate_buffer,
+	stream_map_invalidate_range,
+	stream_map_unsynchronized,
+	stream_persistent_coherent,
+	stream_persistent_flush,
+};
+
+static void
+setup_stream(enum strategy strategy)
+{
+	unsigned align = target == GL_UNIFORM_BUFFER ? ubo_alignment : 64;
+	unsigned size = strategy == ORPHAN ||
+			strategy == MAP_INVALIDATE_BUFFER ?
+			stream_size : RING_SIZE;
+
+	stream_stride = ALIGN(stream_size, align);
+	offset = 0;
+
+	glGenBuffers(1, &buf);
+	glBindBuffer(target, buf);
+
+	if (strategy == PERSISTENT_COHERENT) {
+		GLbitfield flags = GL_MAP_WRITE_BIT |
+				   GL_MAP_PERSISTENT_BIT |
+				   GL_MAP_COHERENT_BIT;
+
+		glBufferStorage(target, size, NULL, flags);
+		persistent_map = glMapBufferRange(target, 0, size, flags);
+	} else if (strategy == PERSISTENT_FLUSH) {
+		glBufferStorage(target, size, NULL,
+				GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT);
+		persistent_map = glMapBufferRange(target, 0, size,
+						  GL_MAP_WRITE_BIT |
+						  GL_MAP_PERSISTENT_BIT |
+						  GL_MAP_FLUSH_EXPLICIT_BIT);
+	} else {
+		glBufferData(target, size, NULL, GL_STREAM_DRAW);
+	}
+
+	if (target == GL_ARRAY_BUFFER)
+		glEnableVertexAttribArray(0);
+	glUseProgram(prog);
+}
+
+static void
+teardown_stream(void)
+{
+	unsigned i;
+
+	for (i = 0; i < NUM_SEGMENTS; i++) {
+		if (fences[i]) {
+			glDeleteSync(fences[i]);
+			fences[i] = NULL;
+		}
+	}
+
+	if (persistent_map) {
+		glUnmapBuffer(target);
+		persistent_map = NULL;
+	}
+
+	glDisableVertexAttribArray(0);
+	glBindBuffer(target, 0);
+	glDeleteBuffers(1, &buf);
+}
+
+static void
+perf_run(const char *stream_name, enum strategy strategy)
+{
+	static unsigned test_index;
+	double rate;
+
+	setup_stream(strategy);
+	rate = perf_measure_rate(strategy_funcs[strategy]);
+	teardown_stream();
+
+	printf(" %3u: %s %6u B w/ %-32s %s draws/sec",
+	       ++test_index, stream_name, stream_size,
+	       strategy_names[strategy], perf_human_float(rate));
+	printf(", %s MB/sec\n",
+	       perf_human_float(rate * stream_size / 1000000.0));
+}
+
+static void
+perf_stream_variant(const char *stream_name, GLenum stream_target,
+		    const unsigned *sizes, unsigned num_sizes)
+{
+	unsigned i, s;
+
+	target = stream_target;
+
+	for (i = 0; i < num_sizes; i++) {
+		stream_size = sizes[i];
+		prog = target == GL_ARRAY_BUFFER ? vs_prog : ubo_progs[i];
+
+		for (s = 0; s < ARRAY_SIZE(strategy_funcs); s++) {
+			if ((s == PERSISTENT_COHERENT ||
+			     s == PERSISTENT_FLUSH) && !has_buffer_storage)
+				continue;
+
+			perf_run(stream_name, s);
+		}
+	}
+}
+
+/** Called from test harness/main */
+enum piglit_result
+piglit_display(void)
+{
+	static const unsigned vertex_sizes[] = { 64, 1024, 16384, 262144 };
+	static const unsigned uniform_sizes[] = { 64, 1024, 16384 };
+
+	perf_stream_variant("vertex ", GL_ARRAY_BUFFER,
+			    vertex_sizes, ARRAY_SIZE(vertex_sizes));
+	perf_stream_variant("uniform", GL_UNIFORM_BUFFER,
+			    uniform_sizes, ARRAY_SIZE(uniform_sizes));
+
+	exit(0);
+	return PIGLIT_SKIP;
+}
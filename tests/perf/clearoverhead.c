@@ -0,0 +1,357 @@
+/*
+ * Copyright © 2026 The Piglit project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * Measure framebuffer clear throughput in pixels per second.
+ *
+ * Sweeps colour, depth and depth/stencil formats (single-sampled and 4x
+ * MSAA) over a few sizes, clearing with glClear, glClearBuffer*,
+ * glClearTexImage and scissored glClear.  Each method is run with
+ * values that fast clears usually handle (0 and 1), with other values,
+ * and with the same value every time, which shows whether redundant
+ * clears are skipped.  Counterpart to the correctness tests in
+ * tests/fast_color_clear.
+ */
+
+#include "common.h"
+#include <stdbool.h>
+#include "piglit-util-gl.h"
+
+PIGLIT_GL_TEST_CONFIG_BEGIN
+
+	config.supports_gl_compat_version = 0;
+	config.supports_gl_core_version = 32;
+
+	puts("Clear throughput:");
+
+	config.window_visual = PIGLIT_GL_VISUAL_RGBA | PIGLIT_GL_VISUAL_DOUBLE;
+
+PIGLIT_GL_TEST_CONFIG_END
+
+enum aspect {
+	COLOR,
+	DEPTH,
+	DEPTH_STENCIL,
+};
+
+static const struct clear_format {
+	GLenum internalformat;
+	const char *name;
+	enum aspect aspect;
+	unsigned samples;
+} formats[] = {
+	{ GL_RGBA8, "RGBA8", COLOR, 0 },
+	{ GL_R8, "R8", COLOR, 0 },
+	{ GL_RGB10_A2, "RGB10_A2", COLOR, 0 },
+	{ GL_RGBA16F, "RGBA16F", COLOR, 0 },
+	{ GL_RGBA32F, "RGBA32F", COLOR, 0 },
+	{ GL_DEPTH_COMPONENT16, "DEPTH16", DEPTH, 0 },
+	{ GL_DEPTH_COMPONENT24, "DEPTH24", DEPTH, 0 },
+	{ GL_DEPTH_COMPONENT32F, "DEPTH32F", DEPTH, 0 },
+	{ GL_DEPTH24_STENCIL8, "DEPTH24_STENCIL8", DEPTH_STENCIL, 0 },
+	{ GL_DEPTH32F_STENCIL8, "DEPTH32F_STENCIL8", DEPTH_STENCIL, 0 },
+	{ GL_RGBA8, "RGBA8 4x MSAA", COLOR, 4 },
+	{ GL_RGBA16F, "RGBA16F 4x MSAA", COLOR, 4 },
+	{ GL_DEPTH24_STENCIL8, "DEPTH24_STENCIL8 4x MSAA", DEPTH_STENCIL, 4 },
+};
+
+/* Each clear alternates between the two values of a set, so that
+ * drivers can't skip clears to the value that is already there, except
+ * for the "same value" set which measures exactly that.
+ */
+static const struct clear_values {
+	const char *name;
+	float color[2][4];
+	float depth[2];
+	int stencil[2];
+} value_sets[] = {
+	{ "0/1", { { 0, 0, 0, 0 }, { 1, 1, 1, 1 } }, { 0, 1 }, { 0, 0xff } },
+	{ "other", { { 0.3, 0.6, 0.2, 0.9 }, { 0.7, 0.1, 0.5, 0.4 } },
+	  { 0.25, 0.75 }, { 0x35, 0x5a } },
+	{ "same value", { { 0, 0, 0, 0 }, { 0, 0, 0, 0 } }, { 1, 1 }, { 0, 0 } },
+};
+
+static bool has_clear_texture;
+
+/* State of the clear being measured. */
+static const struct clear_format *cur;
+static const struct clear_values *values;
+static GLuint tex, fbo;
+static unsigned size;
+
+static GLenum
+get_target(void)
+{
+	return cur->samples ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+}
+
+static void
+clear(unsigned count)
+{
+	unsigned i;
+
+	for (i = 0; i < count; i++) {
+		unsigned v = i & 1;
+
+		switch (cur->aspect) {
+		case COLOR:
+			glClearColor(values->color[v][0], values->color[v][1],
+				     values->color[v][2], values->color[v][3]);
+			glClear(GL_COLOR_BUFFER_BIT);
+			break;
+		case DEPTH:
+			glClearDepth(values->depth[v]);
+			glClear(GL_DEPTH_BUFFER_BIT);
+			break;
+		case DEPTH_STENCIL:
+			glClearDepth(values->depth[v]);
+			glClearStencil(values->stencil[v]);
+			glClear(GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+			break;
+		}
+	}
+}
+
+static void
+clear_buffer(unsigned count)
+{
+	unsigned i;
+
+	for (i = 0; i < count; i++) {
+		unsigned v = i & 1;
+
+		switch (cur->aspect) {
+		case COLOR:
+			glClearBufferfv(GL_COLOR, 0, values->color[v]);
+			break;
+		case DEPTH:
+			glClearBufferfv(GL_DEPTH, 0, &values->depth[v]);
+			break;
+		case DEPTH_STENCIL:
+			glClearBufferfi(GL_DEPTH_STENCIL, 0, values->depth[v],
+					values->stencil[v]);
+			break;
+		}
+	}
+}
+
+static void
+clear_tex_image(unsigned count)
+{
+	unsigned i;
+
+	for (i = 0; i < count; i++) {
+		unsigned v = i & 1;
+
+		switch (cur->aspect) {
+		case COLOR:
+			glClearTexImage(tex, 0, GL_RGBA, GL_FLOAT,
+					values->color[v]);
+			break;
+		case DEPTH:
+			glClearTexImage(tex, 0, GL_DEPTH_COMPONENT, GL_FLOAT,
+					&values->depth[v]);
+			break;
+		case DEPTH_STENCIL:
+			if (cur->internalformat == GL_DEPTH32F_STENCIL8) {
+				struct {
+					float depth;
+					uint32_t stencil;
+				} ds = { values->depth[v], values->stencil[v] };
+
+				glClearTexImage(tex, 0, GL_DEPTH_STENCIL,
+						GL_FLOAT_32_UNSIGNED_INT_24_8_REV,
+						&ds);
+			} else {
+				uint32_t ds = (uint32_t)
+					(values->depth[v] * 0xffffff) << 8 |
+					values->stencil[v];
+
+				glClearTexImage(tex, 0, GL_DEPTH_STENCIL,
+						GL_UNSIGNED_INT_24_8, &ds);
+			}
+			break;
+		}
+	}
+}
+
+static void
+clear_scissor_half(unsigned count)
+{
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(0, 0, size / 2, size);
+	clear(count);
+	glDisable(GL_SCISSOR_TEST);
+}
+
+static void
+clear_scissor_unaligned(unsigned count)
+{
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(3, 3, size - 6, size - 6);
+	clear(count);
+	glDisable(GL_SCISSOR_TEST);
+}
+
+static const struct clear_method {
+	const char *name;
+	perf_rate_func func;
+	/* Which part of the framebuffer is cleared, for the pixel rate. */
+	bool half;
+	bool inset;
+} methods[] = {
+	{ "glClear", clear, false, false },
+	{ "glClearBuffer", clear_buffer, false, false },
+	{ "glClearTexImage", clear_tex_image, false, false },
+	{ "glClear scissor 1/2", clear_scissor_half, true, false },
+	{ "glClear scissor inset 3px", clear_scissor_unaligned, false, true },
+};
+
+static bool
+setup_framebuffer(void)
+{
+	GLenum target = get_target();
+	GLenum attachment = cur->aspect == COLOR ? GL_COLOR_ATTACHMENT0 :
+			    cur->aspect == DEPTH ? GL_DEPTH_ATTACHMENT :
+			    GL_DEPTH_STENCIL_ATTACHMENT;
+
+	glGenTextures(1, &tex);
+	glBindTexture(target, tex);
+
+	if (cur->samples) {
+		glTexImage2DMultisample(target, cur->samples,
+					cur->internalformat, size, size,
+					GL_TRUE);
+	} else {
+		GLenum format = cur->aspect == COLOR ? GL_RGBA :
+				cur->aspect == DEPTH ? GL_DEPTH_COMPONENT :
+				GL_DEPTH_STENCIL;
+		GLenum type = cur->aspect != DEPTH_STENCIL ? GL_FLOAT :
+			cur->internalformat == GL_DEPTH32F_STENCIL8 ?
+			GL_FLOAT_32_UNSIGNED_INT_24_8_REV :
+			GL_UNSIGNED_INT_24_8;
+
+		glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexImage2D(target, 0, cur->internalformat, size, size, 0,
+			     format, type, NULL);
+	}
+
+	glGenFramebuffers(1, &fbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, target, tex, 0);
+	glDrawBuffer(cur->aspect == COLOR ? GL_COLOR_ATTACHMENT0 : GL_NONE);
+	glReadBuffer(GL_NONE);
+	glViewport(0, 0, size, size);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) !=
+	    GL_FRAMEBUFFER_COMPLETE || !piglit_check_gl_error(GL_NO_ERROR)) {
+		glBindFramebuffer(GL_FRAMEBUFFER, piglit_winsys_fbo);
+		glDeleteFramebuffers(1, &fbo);
+		glDeleteTextures(1, &tex);
+		return false;
+	}
+
+	return true;
+}
+
+static void
+teardown_framebuffer(void)
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, piglit_winsys_fbo);
+	glDeleteFramebuffers(1, &fbo);
+	glDeleteTextures(1, &tex);
+}
+
+static void
+perf_run(const struct clear_method *method)
+{
+	static unsigned test_index;
+	double pixels = (double) size * size;
+	double rate;
+
+	if (method->half)
+		pixels /= 2;
+	else if (method->inset)
+		pixels = (double) (size - 6) * (size - 6);
+
+	rate = perf_measure_rate(method->func);
+
+	printf(" %3u: %-26s %4ux%-4u %-26s %-10s %s clears/sec, "
+	       "%.2f Gpixels/sec\n",
+	       ++test_index, cur->name, size, size, method->name,
+	       values->name, perf_human_float(rate),
+	       rate * pixels / 1000000000.0);
+}
+
+void
+piglit_init(int argc, char **argv)
+{
+	piglit_require_gl_version(32);
+
+	has_clear_texture = piglit_get_gl_version() >= 44 ||
+		piglit_is_extension_supported("GL_ARB_clear_texture");
+}
+
+/** Called from test harness/main */
+enum piglit_result
+piglit_display(void)
+{
+	static const unsigned sizes[] = { 512, 2048 };
+	GLint max_samples;
+	unsigned f, s, m, v;
+
+	glGetIntegerv(GL_MAX_SAMPLES, &max_samples);
+
+	for (f = 0; f < ARRAY_SIZE(formats); f++) {
+		cur = &formats[f];
+
+		if (cur->samples > max_samples)
+			continue;
+
+		for (s = 0; s < ARRAY_SIZE(sizes); s++) {
+			size = sizes[s];
+
+			if (!setup_framebuffer()) {
+				printf("      %-26s %4ux%-4u unsupported\n",
+				       cur->name, size, size);
+				continue;
+			}
+
+			for (m = 0; m < ARRAY_SIZE(methods); m++) {
+				if (methods[m].func == clear_tex_image &&
+				    !has_clear_texture)
+					continue;
+
+				for (v = 0; v < ARRAY_SIZE(value_sets); v++) {
+					values = &value_sets[v];
+					perf_run(&methods[m]);
+				}
+			}
+
+			teardown_framebuffer();
+		}
+	}
+
+	exit(0);
+	return PIGLIT_SKIP;
+}
@@ -115,3 +115,28 @@ perf_human_float( double d )
 
 	return buf;
 }
+
+static int
+compare_double(const void *a, const void *b)
+{
+	const double x = *(const double *) a;
+	const double y = *(const double *) b;
+
+	return x < y ? -1 : x > y;
+}
+
+/**
+ * Return the nearest-rank percentile (0-100) of 'count' samples.
+ * Note: sorts 'samples' in place.
+ */
+double
+perf_percentile(double *samples, unsigned count, unsigned percentile)
+{
+	unsigned rank = (percentile * count + 99) / 100;
+
+	if (count == 0)
+		return 0.0;
+
+	qsort(samples, count, sizeof(*samples), compare_double);
+	return samples[rank ? rank - 1 : 0];
+}
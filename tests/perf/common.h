@@ -30,5 +30,8 @@ perf_measure_rate(perf_rate_func f);
 const char *
 perf_human_float( double d );
 
+double
+perf_percentile(double *samples, unsigned count, unsigned percentile);
+
 #endif /* COMMON_H */
 
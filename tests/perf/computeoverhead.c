@@ -0,0 +1,264 @@
+/*
+ * Copyright © 2026 The Piglit project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * Measure compute dispatch overhead and SSBO bandwidth.
+ *
+ * The overhead tests dispatch a single invocation per call, with and
+ * without SSBO/image binding changes and memory barriers, directly and
+ * through glDispatchComputeIndirect.  The bandwidth test copies one SSBO
+ * into another with a uvec4 per invocation for growing buffer sizes.
+ */
+
+#include "common.h"
+#include <stdbool.h>
+#include "piglit-util-gl.h"
+
+PIGLIT_GL_TEST_CONFIG_BEGIN
+
+	config.supports_gl_compat_version = 0;
+	config.supports_gl_core_version = 32;
+
+	puts("Compute dispatches per second:");
+
+	config.window_visual = PIGLIT_GL_VISUAL_RGBA | PIGLIT_GL_VISUAL_DOUBLE;
+
+PIGLIT_GL_TEST_CONFIG_END
+
+#define COPY_LOCAL_SIZE 256
+
+static const char empty_cs[] =
+	"#version 430\n"
+	"layout(local_size_x = 1) in;\n"
+	"void main() {}\n";
+
+static const char resource_cs[] =
+	"#version 430\n"
+	"layout(local_size_x = 1) in;\n"
+	"layout(std430, binding = 0) buffer b { uint v[]; };\n"
+	"layout(binding = 0, r32ui) readonly uniform uimage2D img;\n"
+	"void main() {\n"
+	"	if (v[0] == 12345u && imageLoad(img, ivec2(0)).x == 1u)\n"
+	"		v[1] = 0u;\n"
+	"}\n";
+
+static const char copy_cs[] =
+	"#version 430\n"
+	"layout(local_size_x = 256) in;\n"
+	"layout(std430, binding = 0) readonly buffer src { uvec4 s[]; };\n"
+	"layout(std430, binding = 1) writeonly buffer dst { uvec4 d[]; };\n"
+	"void main() {\n"
+	"	d[gl_GlobalInvocationID.x] = s[gl_GlobalInvocationID.x];\n"
+	"}\n";
+
+static GLuint empty_prog, resource_prog, copy_prog;
+static GLuint ssbo[2], tex[2], indirect_bo;
+static unsigned copy_groups;
+
+static GLuint
+build_compute_program(const char *source)
+{
+	GLuint cs = piglit_compile_shader_text(GL_COMPUTE_SHADER, source);
+	GLuint prog = glCreateProgram();
+
+	glAttachShader(prog, cs);
+	glLinkProgram(prog);
+	glDeleteShader(cs);
+
+	if (!piglit_link_check_status(prog))
+		piglit_report_result(PIGLIT_FAIL);
+
+	return prog;
+}
+
+void
+piglit_init(int argc, char **argv)
+{
+	static const GLuint indirect[3] = { 1, 1, 1 };
+	static const GLuint zero[4];
+	unsigned i;
+
+	piglit_require_gl_version(43);
+
+	empty_prog = build_compute_program(empty_cs);
+	resource_prog = build_compute_program(resource_cs);
+	copy_prog = build_compute_program(copy_cs);
+
+	glGenBuffers(2, ssbo);
+	glGenTextures(2, tex);
+	for (i = 0; i < 2; i++) {
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo[i]);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(zero), zero,
+			     GL_STATIC_DRAW);
+
+		glBindTexture(GL_TEXTURE_2D, tex[i]);
+		glTexStorage2D(GL_TEXTURE_2D, 1, GL_R32UI, 4, 4);
+	}
+
+	glGenBuffers(1, &indirect_bo);
+	glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, indirect_bo);
+	glBufferData(GL_DISPATCH_INDIRECT_BUFFER, sizeof(indirect), indirect,
+		     GL_STATIC_DRAW);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ssbo[0]);
+	glBindImageTexture(0, tex[0], 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32UI);
+}
+
+static void
+dispatch(unsigned count)
+{
+	unsigned i;
+
+	for (i = 0; i < count; i++)
+		glDispatchCompute(1, 1, 1);
+}
+
+static void
+dispatch_barrier(unsigned count)
+{
+	unsigned i;
+
+	for (i = 0; i < count; i++) {
+		glDispatchCompute(1, 1, 1);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+	}
+}
+
+static void
+dispatch_indirect(unsigned count)
+{
+	unsigned i;
+
+	for (i = 0; i < count; i++)
+		glDispatchComputeIndirect(0);
+}
+
+static void
+dispatch_ssbo_change(unsigned count)
+{
+	unsigned i;
+
+	for (i = 0; i < count; i++) {
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ssbo[i & 1]);
+		glDispatchCompute(1, 1, 1);
+	}
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ssbo[0]);
+}
+
+static void
+dispatch_image_change(unsigned count)
+{
+	unsigned i;
+
+	for (i = 0; i < count; i++) {
+		glBindImageTexture(0, tex[i & 1], 0, GL_FALSE, 0,
+				   GL_READ_ONLY, GL_R32UI);
+		glDispatchCompute(1, 1, 1);
+	}
+	glBindImageTexture(0, tex[0], 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32UI);
+}
+
+static void
+dispatch_copy(unsigned count)
+{
+	unsigned i;
+
+	for (i = 0; i < count; i++)
+		glDispatchCompute(copy_groups, 1, 1);
+}
+
+static void
+perf_run(const char *name, GLuint prog, perf_rate_func f)
+{
+	static unsigned test_index;
+	double rate;
+
+	glUseProgram(prog);
+	rate = perf_measure_rate(f);
+
+	printf(" %3u: %-28s %s dispatches/sec\n",
+	       ++test_index, name, perf_human_float(rate));
+}
+
+static void
+perf_run_bandwidth(void)
+{
+	GLint max_block_size, max_groups;
+	GLuint bufs[2];
+	unsigned size;
+
+	glGetIntegerv(GL_MAX_SHADER_STORAGE_BLOCK_SIZE, &max_block_size);
+	glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_COUNT, 0, &max_groups);
+
+	puts("SSBO copy bandwidth (read + write):");
+	glUseProgram(copy_prog);
+
+	for (size = 1024 * 1024; size <= 256 * 1024 * 1024; size *= 4) {
+		double rate;
+
+		copy_groups = size / 16 / COPY_LOCAL_SIZE;
+		if (size > (unsigned) max_block_size ||
+		    copy_groups > (unsigned) max_groups)
+			break;
+
+		glGenBuffers(2, bufs);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, bufs[0]);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, size, NULL,
+			     GL_STATIC_DRAW);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, bufs[1]);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, size, NULL,
+			     GL_STATIC_DRAW);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, bufs[0]);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, bufs[1]);
+
+		rate = perf_measure_rate(dispatch_copy);
+
+		printf("      %4u MB: %s dispatches/sec, %.2f GB/sec\n",
+		       size / (1024 * 1024), perf_human_float(rate),
+		       rate * size * 2 / 1000000000.0);
+
+		glDeleteBuffers(2, bufs);
+	}
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ssbo[0]);
+}
+
+/** Called from test harness/main */
+enum piglit_result
+piglit_display(void)
+{
+	perf_run("empty", empty_prog, dispatch);
+	perf_run("empty w/ barrier", empty_prog, dispatch_barrier);
+	perf_run("empty indirect", empty_prog, dispatch_indirect);
+	perf_run("SSBO+image", resource_prog, dispatch);
+	perf_run("SSBO+image w/ SSBO change", resource_prog,
+		 dispatch_ssbo_change);
+	perf_run("SSBO+image w/ image change", resource_prog,
+		 dispatch_image_change);
+	perf_run("SSBO+image indirect", resource_prog, dispatch_indirect);
+
+	perf_run_bandwidth();
+
+	exit(0);
+	return PIGLIT_SKIP;
+}
@@ -0,0 +1,493 @@
+/*
+ * Copyright © 2026 The Piglit project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * Measure shader compile and link latency over a set of .shader_test files
+ * and glslparsertest stage files (.vert, .tesc, .tese, .geom, .frag, .comp).
+ *
+ * Usage: shadercompile [-core] [-iterations N] [-threads N] [-allow-cache]
+ *                      files...
+ *
+ * Each file is compiled (and, for .shader_test files, linked) once to check
+ * that the driver accepts it, then N more times for timing.  A unique comment
+ * is appended to every source so that driver shader caches are defeated,
+ * unless -allow-cache is given.
+ *
+ * With -threads N, GL_ARB_parallel_shader_compile is used to let the driver
+ * compile on N threads, and the whole set is submitted before any status is
+ * queried, which measures the compiler's throughput rather than its latency.
+ */
+
+#include "common.h"
+#include <stdbool.h>
+#include "piglit-util-gl.h"
+
+PIGLIT_GL_TEST_CONFIG_BEGIN
+
+	config.supports_gl_compat_version = 10;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-core")) {
+			config.supports_gl_compat_version = 0;
+			config.supports_gl_core_version = 32;
+			break;
+		}
+	}
+
+	config.window_visual = PIGLIT_GL_VISUAL_RGBA | PIGLIT_GL_VISUAL_DOUBLE;
+
+PIGLIT_GL_TEST_CONFIG_END
+
+#define MAX_SHADERS 16
+
+static const char passthrough_vertex_shader_source[] =
+	"#if __VERSION__ >= 130\n"
+	"in vec4 piglit_vertex;\n"
+	"#else\n"
+	"attribute vec4 piglit_vertex;\n"
+	"#endif\n"
+	"void main() { gl_Position = piglit_vertex; }\n"
+	;
+
+struct shader_source {
+	GLenum target;
+	const char *text;
+	GLint length;
+};
+
+struct test_file {
+	const char *name;
+	char *text;
+	struct shader_source shaders[MAX_SHADERS];
+	unsigned num_shaders;
+	bool link;
+	bool usable;
+
+	/* Objects of an in-flight build in -threads mode. */
+	GLuint shader_objs[MAX_SHADERS];
+	GLuint prog;
+
+	double *compile_ms;
+	double *link_ms;
+};
+
+static const struct {
+	const char *name;
+	GLenum target;
+} shader_sections[] = {
+	{ "[vertex shader]", GL_VERTEX_SHADER },
+	{ "[tessellation control shader]", GL_TESS_CONTROL_SHADER },
+	{ "[tessellation evaluation shader]", GL_TESS_EVALUATION_SHADER },
+	{ "[geometry shader]", GL_GEOMETRY_SHADER },
+	{ "[fragment shader]", GL_FRAGMENT_SHADER },
+	{ "[compute shader]", GL_COMPUTE_SHADER },
+};
+
+static const struct {
+	const char *ext;
+	GLenum target;
+} stage_extensions[] = {
+	{ ".vert", GL_VERTEX_SHADER },
+	{ ".tesc", GL_TESS_CONTROL_SHADER },
+	{ ".tese", GL_TESS_EVALUATION_SHADER },
+	{ ".geom", GL_GEOMETRY_SHADER },
+	{ ".frag", GL_FRAGMENT_SHADER },
+	{ ".comp", GL_COMPUTE_SHADER },
+};
+
+static struct test_file *files;
+static unsigned num_files;
+static unsigned iterations = 10;
+static unsigned num_threads;
+static bool allow_cache;
+static unsigned serial;
+
+static bool
+add_shader(struct test_file *f, GLenum target, const char *text, GLint length)
+{
+	if (f->num_shaders == MAX_SHADERS) {
+		printf("%s: too many shaders, skipping\n", f->name);
+		return false;
+	}
+
+	f->shaders[f->num_shaders].target = target;
+	f->shaders[f->num_shaders].text = text;
+	f->shaders[f->num_shaders].length = length;
+	f->num_shaders++;
+	return true;
+}
+
+/**
+ * Collect the GLSL sections of a .shader_test file.  This follows the
+ * section names of shader_runner's process_test_script(), but only keeps
+ * the shader sources; [require] is left to the warm-up compile.
+ */
+static bool
+parse_shader_test(struct test_file *f)
+{
+	const char *line = f->text;
+	const char *shader_start = NULL;
+	GLenum shader_target = 0;
+
+	while (line[0] != '\0') {
+		if (line[0] == '[') {
+			unsigned i;
+
+			if (shader_start &&
+			    !add_shader(f, shader_target, shader_start,
+					line - shader_start))
+				return false;
+			shader_start = NULL;
+
+			if (strncmp(line, "[test]", 6) == 0)
+				break;
+
+			if (strncmp(line, "[vertex shader passthrough]", 27) == 0 &&
+			    !add_shader(f, GL_VERTEX_SHADER,
+					passthrough_vertex_shader_source, -1))
+				return false;
+
+			for (i = 0; i < ARRAY_SIZE(shader_sections); i++) {
+				const char *name = shader_sections[i].name;
+
+				if (strncmp(line, name, strlen(name)) == 0) {
+					shader_target = shader_sections[i].target;
+					shader_start = strchrnul(line, '\n');
+					if (shader_start[0] != '\0')
+						shader_start++;
+					break;
+				}
+			}
+		}
+
+		line = strchrnul(line, '\n');
+		if (line[0] != '\0')
+			line++;
+	}
+
+	if (shader_start &&
+	    !add_shader(f, shader_target, shader_start, line - shader_start))
+		return false;
+
+	f->link = true;
+	return f->num_shaders > 0;
+}
+
+static bool
+load_file(struct test_file *f, const char *name)
+{
+	const char *ext = strrchr(name, '.');
+	GLenum target = 0;
+	unsigned size;
+	unsigned i;
+	bool ok;
+
+	memset(f, 0, sizeof(*f));
+	f->name = name;
+
+	for (i = 0; ext && i < ARRAY_SIZE(stage_extensions); i++) {
+		if (strcmp(ext, stage_extensions[i].ext) == 0)
+			target = stage_extensions[i].target;
+	}
+
+	if (target == 0 && (ext == NULL || strcmp(ext, ".shader_test") != 0)) {
+		printf("%s: unknown file type, skipping\n", name);
+		return false;
+	}
+
+	f->text = piglit_load_text_file(name, &size);
+	if (f->text == NULL) {
+		printf("%s: could not read file, skipping\n", name);
+		return false;
+	}
+
+	if (target)
+		ok = add_shader(f, target, f->text, size);
+	else
+		ok = parse_shader_test(f);
+
+	/* The slot is reused for the next file. */
+	if (!ok) {
+		free(f->text);
+		f->text = NULL;
+	}
+	return ok;
+}
+
+static GLuint
+submit_shader(const struct shader_source *src)
+{
+	GLuint shader = glCreateShader(src->target);
+	char suffix[64];
+	const GLchar *strings[2] = { src->text, suffix };
+	GLint lengths[2] = { src->length, -1 };
+
+	snprintf(suffix, sizeof(suffix), "\n// shadercompile %u\n", serial++);
+	glShaderSource(shader, allow_cache ? 1 : 2, strings, lengths);
+	glCompileShader(shader);
+	return shader;
+}
+
+/**
+ * Start compiling and linking every shader of \p f, without waiting for
+ * the results.
+ */
+static void
+submit_file(struct test_file *f)
+{
+	unsigned i;
+
+	for (i = 0; i < f->num_shaders; i++)
+		f->shader_objs[i] = submit_shader(&f->shaders[i]);
+
+	f->prog = 0;
+	if (f->link) {
+		f->prog = glCreateProgram();
+		for (i = 0; i < f->num_shaders; i++)
+			glAttachShader(f->prog, f->shader_objs[i]);
+		glLinkProgram(f->prog);
+	}
+}
+
+/**
+ * Wait for the build started by submit_file() and release its objects.
+ */
+static bool
+finish_file(struct test_file *f)
+{
+	bool pass = true;
+	GLint ok;
+	unsigned i;
+
+	for (i = 0; i < f->num_shaders; i++) {
+		glGetShaderiv(f->shader_objs[i], GL_COMPILE_STATUS, &ok);
+		pass = pass && ok;
+		glDeleteShader(f->shader_objs[i]);
+	}
+
+	if (f->prog) {
+		glGetProgramiv(f->prog, GL_LINK_STATUS, &ok);
+		pass = pass && ok;
+		glDeleteProgram(f->prog);
+	}
+
+	return pass;
+}
+
+/**
+ * Compile and link \p f, timing both steps separately.
+ */
+static bool
+build_file(struct test_file *f, double *compile_ms, double *link_ms)
+{
+	GLuint shaders[MAX_SHADERS];
+	bool pass = true;
+	int64_t t0, t1, t2;
+	GLint ok;
+	unsigned i;
+
+	t0 = piglit_time_get_nano();
+	for (i = 0; i < f->num_shaders; i++)
+		shaders[i] = submit_shader(&f->shaders[i]);
+	for (i = 0; i < f->num_shaders; i++) {
+		glGetShaderiv(shaders[i], GL_COMPILE_STATUS, &ok);
+		pass = pass && ok;
+	}
+	t1 = piglit_time_get_nano();
+
+	if (pass && f->link) {
+		GLuint prog = glCreateProgram();
+
+		for (i = 0; i < f->num_shaders; i++)
+			glAttachShader(prog, shaders[i]);
+		glLinkProgram(prog);
+		glGetProgramiv(prog, GL_LINK_STATUS, &ok);
+		pass = pass && ok;
+		glDeleteProgram(prog);
+	}
+	t2 = piglit_time_get_nano();
+
+	for (i = 0; i < f->num_shaders; i++)
+		glDeleteShader(shaders[i]);
+
+	*compile_ms = (t1 - t0) / 1000000.0;
+	*link_ms = (t2 - t1) / 1000000.0;
+	return pass;
+}
+
+static void
+run_latency(void)
+{
+	double total_compile = 0, total_link = 0;
+	unsigned num_shaders = 0, num_programs = 0;
+	unsigned i, j;
+
+	for (j = 0; j < iterations; j++) {
+		for (i = 0; i < num_files; i++) {
+			struct test_file *f = &files[i];
+
+			if (f->usable)
+				build_file(f, &f->compile_ms[j],
+					   &f->link_ms[j]);
+		}
+	}
+
+	puts("Compile/link latency per file (median / p95):");
+	for (i = 0; i < num_files; i++) {
+		struct test_file *f = &files[i];
+
+		if (!f->usable)
+			continue;
+
+		for (j = 0; j < iterations; j++) {
+			total_compile += f->compile_ms[j];
+			total_link += f->link_ms[j];
+		}
+		num_shaders += f->num_shaders * iterations;
+		num_programs += f->link ? iterations : 0;
+
+		printf("  %s: compile %.3f / %.3f ms",
+		       f->name,
+		       perf_percentile(f->compile_ms, iterations, 50),
+		       perf_percentile(f->compile_ms, iterations, 95));
+		if (f->link) {
+			printf(", link %.3f / %.3f ms",
+			       perf_percentile(f->link_ms, iterations, 50),
+			       perf_percentile(f->link_ms, iterations, 95));
+		}
+		printf("\n");
+	}
+
+	if (num_shaders) {
+		printf("Total: %.3f ms per shader compile (%s shaders/sec)\n",
+		       total_compile / num_shaders,
+		       perf_human_float(num_shaders * 1000.0 / total_compile));
+	}
+	if (num_programs) {
+		printf("Total: %.3f ms per program link (%s programs/sec)\n",
+		       total_link / num_programs,
+		       perf_human_float(num_programs * 1000.0 / total_link));
+	}
+}
+
+static void
+run_throughput(void)
+{
+	double *total_ms = calloc(iterations, sizeof(double));
+	unsigned num_shaders = 0;
+	unsigned i, j;
+
+	glMaxShaderCompilerThreadsARB(num_threads);
+
+	for (i = 0; i < num_files; i++) {
+		if (files[i].usable)
+			num_shaders += files[i].num_shaders;
+	}
+
+	for (j = 0; j < iterations; j++) {
+		int64_t t0 = piglit_time_get_nano();
+
+		for (i = 0; i < num_files; i++) {
+			if (files[i].usable)
+				submit_file(&files[i]);
+		}
+		for (i = 0; i < num_files; i++) {
+			if (files[i].usable)
+				finish_file(&files[i]);
+		}
+
+		total_ms[j] = (piglit_time_get_nano() - t0) / 1000000.0;
+	}
+
+	printf("Compile+link of %u shaders on %u threads: "
+	       "%.3f ms median, %.3f ms p95 (%s shaders/sec)\n",
+	       num_shaders, num_threads,
+	       perf_percentile(total_ms, iterations, 50),
+	       perf_percentile(total_ms, iterations, 95),
+	       perf_human_float(num_shaders * 1000.0 /
+				perf_percentile(total_ms, iterations, 50)));
+	free(total_ms);
+}
+
+void
+piglit_init(int argc, char **argv)
+{
+	unsigned i;
+
+	piglit_require_GLSL();
+
+	files = calloc(argc, sizeof(*files));
+
+	for (i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-core")) {
+			continue;
+		} else if (!strcmp(argv[i], "-allow-cache")) {
+			allow_cache = true;
+		} else if (!strcmp(argv[i], "-iterations") && i + 1 < argc) {
+			iterations = MAX2(strtoul(argv[++i], NULL, 0), 1);
+		} else if (!strcmp(argv[i], "-threads") && i + 1 < argc) {
+			num_threads = strtoul(argv[++i], NULL, 0);
+		} else if (load_file(&files[num_files], argv[i])) {
+			num_files++;
+		}
+	}
+
+	if (num_files == 0) {
+		printf("usage: %s [-core] [-iterations N] [-threads N] "
+		       "[-allow-cache] files...\n", argv[0]);
+		piglit_report_result(PIGLIT_FAIL);
+	}
+
+	if (num_threads)
+		piglit_require_extension("GL_ARB_parallel_shader_compile");
+
+	/* Drop the files this driver can't build, so that failures don't
+	 * skew the numbers.
+	 */
+	for (i = 0; i < num_files; i++) {
+		struct test_file *f = &files[i];
+		double compile_ms, link_ms;
+
+		f->usable = build_file(f, &compile_ms, &link_ms);
+		if (!f->usable) {
+			printf("%s: failed to compile or link, skipping\n",
+			       f->name);
+			continue;
+		}
+
+		f->compile_ms = calloc(iterations, sizeof(double));
+		f->link_ms = calloc(iterations, sizeof(double));
+	}
+}
+
+/** Called from test harness/main */
+enum piglit_result
+piglit_display(void)
+{
+	if (num_threads)
+		run_throughput();
+	else
+		run_latency();
+
+	exit(0);
+	return PIGLIT_SKIP;
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright © 2026 The Piglit project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * Measure the round-trip latency of the GL and EGL synchronization
+ * primitives: glFenceSync/glClientWaitSync, eglCreateSyncKHR/
+ * eglClientWaitSyncKHR, query object readback and glFinish.
+ *
+ * Each primitive is sampled repeatedly and reported as p50/p99/max, first
+ * on an idle system, then with every CPU kept busy by spinning threads,
+ * and then with a batch of full-window draws queued ahead of each sample.
+ */
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "piglit-util-gl.h"
+#include "piglit-util-egl.h"
+#include "../egl/egl-util.h"
+
+#define NUM_SAMPLES 1000
+#define GPU_LOAD_DRAWS 16
+
+enum load {
+	LOAD_IDLE,
+	LOAD_CPU,
+	LOAD_GPU,
+};
+
+static const char *load_names[] = {
+	"idle",
+	"CPU load",
+	"GPU load",
+};
+
+/* Use prefix 'pegl' to avoid collisions with prototypes in eglext.h. */
+static EGLSyncKHR (*peglCreateSyncKHR)(EGLDisplay dpy, EGLenum type,
+				       const EGLint *attrib_list);
+static EGLBoolean (*peglDestroySyncKHR)(EGLDisplay dpy, EGLSyncKHR sync);
+static EGLint (*peglClientWaitSyncKHR)(EGLDisplay dpy, EGLSyncKHR sync,
+				       EGLint flags, EGLTimeKHR timeout);
+
+static EGLDisplay egl_dpy;
+static enum load load;
+static GLuint query;
+static volatile bool spinning;
+
+static void
+sample_gl_fence(void)
+{
+	GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+	glDeleteSync(sync);
+}
+
+static void
+sample_egl_fence(void)
+{
+	EGLSyncKHR sync = peglCreateSyncKHR(egl_dpy, EGL_SYNC_FENCE_KHR,
+					    NULL);
+
+	peglClientWaitSyncKHR(egl_dpy, sync, EGL_SYNC_FLUSH_COMMANDS_BIT_KHR,
+			      EGL_FOREVER_KHR);
+	peglDestroySyncKHR(egl_dpy, sync);
+}
+
+static void
+sample_query(void)
+{
+	GLuint samples;
+
+	glBeginQuery(GL_SAMPLES_PASSED, query);
+	piglit_draw_rect(-1, -1, 0.1, 0.1);
+	glEndQuery(GL_SAMPLES_PASSED);
+	glGetQueryObjectuiv(query, GL_QUERY_RESULT, &samples);
+}
+
+static void
+sample_finish(void)
+{
+	glFinish();
+}
+
+static void *
+spin(void *arg)
+{
+	while (spinning)
+		;
+	return NULL;
+}
+
+/**
+ * Sample \p f NUM_SAMPLES times and print its latency distribution.
+ */
+static void
+perf_run(const char *name, void (*f)(void))
+{
+	double samples[NUM_SAMPLES];
+	unsigned i, j;
+
+	glFinish();
+
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		int64_t t0;
+
+		if (load == LOAD_GPU) {
+			for (j = 0; j < GPU_LOAD_DRAWS; j++)
+				piglit_draw_rect(-1, -1, 2, 2);
+		}
+
+		t0 = piglit_time_get_nano();
+		f();
+		samples[i] = (piglit_time_get_nano() - t0) / 1000.0;
+	}
+
+	printf("  %-9s %-36s p50 %9.1f us, p99 %9.1f us, max %9.1f us\n",
+	       load_names[load], name,
+	       perf_percentile(samples, NUM_SAMPLES, 50),
+	       perf_percentile(samples, NUM_SAMPLES, 99),
+	       perf_percentile(samples, NUM_SAMPLES, 100));
+}
+
+static enum piglit_result
+draw(struct egl_state *state)
+{
+	bool has_egl_fence, has_gl_sync;
+	long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	pthread_t *threads = calloc(MAX2(num_cpus, 1), sizeof(pthread_t));
+	long i;
+
+	egl_dpy = state->egl_dpy;
+
+	has_egl_fence = piglit_is_egl_extension_supported(egl_dpy,
+							  "EGL_KHR_fence_sync");
+	if (has_egl_fence) {
+		peglCreateSyncKHR = (void *)
+			eglGetProcAddress("eglCreateSyncKHR");
+		peglDestroySyncKHR = (void *)
+			eglGetProcAddress("eglDestroySyncKHR");
+		peglClientWaitSyncKHR = (void *)
+			eglGetProcAddress("eglClientWaitSyncKHR");
+	}
+
+	has_gl_sync = piglit_get_gl_version() >= 32 ||
+		piglit_is_extension_supported("GL_ARB_sync");
+
+	glGenQueries(1, &query);
+	glViewport(0, 0, state->width, state->height);
+
+	puts("Synchronization round-trip latency:");
+
+	for (load = LOAD_IDLE; load <= LOAD_GPU; load++) {
+		if (load == LOAD_CPU) {
+			spinning = true;
+			for (i = 0; i < num_cpus; i++)
+				pthread_create(&threads[i], NULL, spin, NULL);
+		}
+
+		if (has_gl_sync) {
+			perf_run("glFenceSync + glClientWaitSync",
+				 sample_gl_fence);
+		}
+		if (has_egl_fence) {
+			perf_run("eglCreateSyncKHR + eglClientWaitSyncKHR",
+				 sample_egl_fence);
+		}
+		perf_run("GL_SAMPLES_PASSED query readback", sample_query);
+		perf_run("glFinish", sample_finish);
+
+		if (load == LOAD_CPU) {
+			spinning = false;
+			for (i = 0; i < num_cpus; i++)
+				pthread_join(threads[i], NULL);
+		}
+	}
+
+	glDeleteQueries(1, &query);
+	free(threads);
+	return PIGLIT_PASS;
+}
+
+int
+main(int argc, char *argv[])
+{
+	struct egl_test test;
+
+	egl_init_test(&test);
+	test.draw = draw;
+
+	if (egl_util_run(&test, argc, argv) != PIGLIT_PASS)
+		return EXIT_FAILURE;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,615 @@
+/*
+ * Copyright © 2026 The Piglit project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * Measure texture upload and readback throughput.
+ *
+ * Usage: texture-transfer [-csv | -json] [-format GL_xxx] [-convert]
+ *                         [-min-size N] [-max-size N]
+ *
+ * Sweeps the GL 3.0 required texture formats from sized-internalformats.c
+ * over square 2D textures of increasing size, and for each one measures
+ * glTexSubImage2D, glGetTexImage and glReadPixels to and from both client
+ * memory and pixel buffer objects.  Compressed formats are measured with
+ * glCompressedTexSubImage2D and glGetCompressedTexImage instead.
+ *
+ * By default the client data uses the format/type that matches the
+ * internal format.  -convert additionally measures GL_RGBA/GL_UNSIGNED_BYTE
+ * and GL_RGBA/GL_FLOAT for normalized and float color formats, which
+ * exercises the drivers' conversion paths.
+ */
+
+#include "common.h"
+#include <stdbool.h>
+#include "piglit-util-gl.h"
+#include "sized-internalformats.h"
+
+PIGLIT_GL_TEST_CONFIG_BEGIN
+
+	config.supports_gl_compat_version = 10;
+
+	config.window_visual = PIGLIT_GL_VISUAL_RGBA | PIGLIT_GL_VISUAL_DOUBLE;
+
+PIGLIT_GL_TEST_CONFIG_END
+
+enum output_mode {
+	OUTPUT_TEXT,
+	OUTPUT_CSV,
+	OUTPUT_JSON,
+};
+
+struct transfer_format {
+	const struct sized_internalformat *sized;
+	GLenum format;
+	GLenum type;
+	unsigned bytes_per_pixel;
+	bool compressed;
+	unsigned block_bytes;
+	GLenum attachment;
+};
+
+static enum output_mode output = OUTPUT_TEXT;
+static const char *format_filter;
+static bool convert;
+static unsigned min_size = 256;
+static unsigned max_size = 1024;
+static unsigned num_results;
+
+/* State of the transfer being measured. */
+static struct transfer_format cur;
+static unsigned size;
+static unsigned image_bytes;
+static GLuint tex, fbo, unpack_pbo, pack_pbo;
+static void *client_data;
+
+static GLenum
+get_transfer_type(const struct sized_internalformat *f, enum channel c)
+{
+	int bits = get_channel_size(f, c);
+	GLenum type = get_channel_type(f, c);
+
+	switch (bits) {
+	case 8:
+		return type == GL_SIGNED_NORMALIZED || type == GL_INT ?
+			GL_BYTE : GL_UNSIGNED_BYTE;
+	case 16:
+		if (type == GL_FLOAT)
+			return GL_HALF_FLOAT;
+		return type == GL_SIGNED_NORMALIZED || type == GL_INT ?
+			GL_SHORT : GL_UNSIGNED_SHORT;
+	case 32:
+		if (type == GL_FLOAT)
+			return GL_FLOAT;
+		return type == GL_INT ? GL_INT : GL_UNSIGNED_INT;
+	default:
+		return GL_NONE;
+	}
+}
+
+static unsigned
+get_type_size(GLenum type)
+{
+	switch (type) {
+	case GL_BYTE:
+	case GL_UNSIGNED_BYTE:
+		return 1;
+	case GL_SHORT:
+	case GL_UNSIGNED_SHORT:
+	case GL_HALF_FLOAT:
+		return 2;
+	default:
+		return 4;
+	}
+}
+
+/**
+ * Pick the client format/type that matches \p f's layout, so that no
+ * conversion is needed.  Returns false for formats that have none.
+ */
+static bool
+get_transfer_format(const struct sized_internalformat *f,
+		    struct transfer_format *t)
+{
+	static const GLenum color_formats[2][4] = {
+		{ GL_RED, GL_RG, GL_RGB, GL_RGBA },
+		{ GL_RED_INTEGER, GL_RG_INTEGER, GL_RGB_INTEGER,
+		  GL_RGBA_INTEGER },
+	};
+	unsigned num_channels = 0;
+	bool integer;
+	enum channel c;
+
+	memset(t, 0, sizeof(*t));
+	t->sized = f;
+	t->attachment = GL_COLOR_ATTACHMENT0;
+
+	if (f->bits[R] == UCMP || f->bits[R] == SCMP) {
+		t->compressed = true;
+		/* RGTC1 is 8 bytes per 4x4 block, RGTC2 twice that. */
+		t->block_bytes = f->bits[G] == NONE ? 8 : 16;
+		return true;
+	}
+
+	/* Packed layouts. */
+	switch (f->token) {
+	case GL_RGB10_A2:
+	case GL_RGB10_A2UI:
+		t->format = f->token == GL_RGB10_A2 ?
+			GL_RGBA : GL_RGBA_INTEGER;
+		t->type = GL_UNSIGNED_INT_2_10_10_10_REV;
+		t->bytes_per_pixel = 4;
+		return true;
+	case GL_R11F_G11F_B10F:
+		t->format = GL_RGB;
+		t->type = GL_UNSIGNED_INT_10F_11F_11F_REV;
+		t->bytes_per_pixel = 4;
+		return true;
+	case GL_RGB9_E5:
+		t->format = GL_RGB;
+		t->type = GL_UNSIGNED_INT_5_9_9_9_REV;
+		t->bytes_per_pixel = 4;
+		return true;
+	case GL_RGB565:
+		t->format = GL_RGB;
+		t->type = GL_UNSIGNED_SHORT_5_6_5;
+		t->bytes_per_pixel = 2;
+		return true;
+	case GL_RGB5_A1:
+		t->format = GL_RGBA;
+		t->type = GL_UNSIGNED_SHORT_5_5_5_1;
+		t->bytes_per_pixel = 2;
+		return true;
+	case GL_RGBA4:
+		t->format = GL_RGBA;
+		t->type = GL_UNSIGNED_SHORT_4_4_4_4;
+		t->bytes_per_pixel = 2;
+		return true;
+	case GL_DEPTH_COMPONENT24:
+		t->format = GL_DEPTH_COMPONENT;
+		t->type = GL_UNSIGNED_INT;
+		t->bytes_per_pixel = 4;
+		t->attachment = GL_DEPTH_ATTACHMENT;
+		return true;
+	case GL_DEPTH24_STENCIL8:
+		t->format = GL_DEPTH_STENCIL;
+		t->type = GL_UNSIGNED_INT_24_8;
+		t->bytes_per_pixel = 4;
+		t->attachment = GL_DEPTH_STENCIL_ATTACHMENT;
+		return true;
+	case GL_DEPTH32F_STENCIL8:
+		t->format = GL_DEPTH_STENCIL;
+		t->type = GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+		t->bytes_per_pixel = 8;
+		t->attachment = GL_DEPTH_STENCIL_ATTACHMENT;
+		return true;
+	}
+
+	if (f->bits[D] != NONE) {
+		t->format = GL_DEPTH_COMPONENT;
+		t->type = get_transfer_type(f, D);
+		t->bytes_per_pixel = get_type_size(t->type);
+		t->attachment = GL_DEPTH_ATTACHMENT;
+		return t->type != GL_NONE;
+	}
+
+	if (f->bits[L] != NONE || f->bits[I] != NONE) {
+		c = f->bits[L] != NONE ? L : I;
+		t->format = f->bits[A] != NONE ?
+			GL_LUMINANCE_ALPHA : GL_LUMINANCE;
+		num_channels = f->bits[A] != NONE ? 2 : 1;
+	} else if (f->bits[R] == NONE && f->bits[A] != NONE) {
+		c = A;
+		t->format = GL_ALPHA;
+		num_channels = 1;
+	} else {
+		c = R;
+		for (num_channels = 0; num_channels < 4; num_channels++) {
+			if (f->bits[num_channels] == NONE)
+				break;
+		}
+		integer = get_channel_type(f, R) == GL_INT ||
+			  get_channel_type(f, R) == GL_UNSIGNED_INT;
+		t->format = color_formats[integer][num_channels - 1];
+	}
+
+	t->type = get_transfer_type(f, c);
+	t->bytes_per_pixel = num_channels * get_type_size(t->type);
+	return t->type != GL_NONE;
+}
+
+static void
+upload_client(unsigned count)
+{
+	unsigned i;
+
+	for (i = 0; i < count; i++) {
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size, size,
+				cur.format, cur.type, client_data);
+	}
+}
+
+static void
+upload_pbo(unsigned count)
+{
+	unsigned i;
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, unpack_pbo);
+	for (i = 0; i < count; i++) {
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size, size,
+				cur.format, cur.type, NULL);
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+static void
+get_tex_image_client(unsigned count)
+{
+	unsigned i;
+
+	for (i = 0; i < count; i++) {
+		glGetTexImage(GL_TEXTURE_2D, 0, cur.format, cur.type,
+			      client_data);
+	}
+}
+
+static void
+get_tex_image_pbo(unsigned count)
+{
+	unsigned i;
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, pack_pbo);
+	for (i = 0; i < count; i++)
+		glGetTexImage(GL_TEXTURE_2D, 0, cur.format, cur.type, NULL);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+static void
+read_pixels_client(unsigned count)
+{
+	unsigned i;
+
+	for (i = 0; i < count; i++) {
+		glReadPixels(0, 0, size, size, cur.format, cur.type,
+			     client_data);
+	}
+}
+
+static void
+read_pixels_pbo(unsigned count)
+{
+	unsigned i;
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, pack_pbo);
+	for (i = 0; i < count; i++) {
+		glReadPixels(0, 0, size, size, cur.format, cur.type,
+			     NULL);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+static void
+compressed_upload_client(unsigned count)
+{
+	unsigned i;
+
+	for (i = 0; i < count; i++) {
+		glCompressedTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size, size,
+					  cur.sized->token, image_bytes,
+					  client_data);
+	}
+}
+
+static void
+compressed_upload_pbo(unsigned count)
+{
+	unsigned i;
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, unpack_pbo);
+	for (i = 0; i < count; i++) {
+		glCompressedTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size, size,
+					  cur.sized->token, image_bytes,
+					  NULL);
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+static void
+compressed_get_tex_image_client(unsigned count)
+{
+	unsigned i;
+
+	for (i = 0; i < count; i++)
+		glGetCompressedTexImage(GL_TEXTURE_2D, 0, client_data);
+}
+
+static void
+compressed_get_tex_image_pbo(unsigned count)
+{
+	unsigned i;
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, pack_pbo);
+	for (i = 0; i < count; i++)
+		glGetCompressedTexImage(GL_TEXTURE_2D, 0, NULL);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+static const struct transfer_method {
+	const char *name;
+	perf_rate_func func;
+	bool compressed;
+	bool needs_fbo;
+} methods[] = {
+	{ "TexSubImage2D client", upload_client, false, false },
+	{ "TexSubImage2D PBO", upload_pbo, false, false },
+	{ "GetTexImage client", get_tex_image_client, false, false },
+	{ "GetTexImage PBO", get_tex_image_pbo, false, false },
+	{ "ReadPixels client", read_pixels_client, false, true },
+	{ "ReadPixels PBO", read_pixels_pbo, false, true },
+	{ "CompressedTexSubImage2D client", compressed_upload_client, true, false },
+	{ "CompressedTexSubImage2D PBO", compressed_upload_pbo, true, false },
+	{ "GetCompressedTexImage client", compressed_get_tex_image_client, true, false },
+	{ "GetCompressedTexImage PBO", compressed_get_tex_image_pbo, true, false },
+};
+
+static void
+print_result(const struct transfer_method *method, double mb_per_sec)
+{
+	const char *format = cur.compressed ? "compressed" :
+		piglit_get_gl_enum_name(cur.format);
+	const char *type = cur.compressed ? "compressed" :
+		piglit_get_gl_enum_name(cur.type);
+
+	switch (output) {
+	case OUTPUT_TEXT:
+		printf("  %-28s %4ux%-4u %-20s %-36s %-30s %10.1f MB/s\n",
+		       cur.sized->name, size, size, format, type,
+		       method->name, mb_per_sec);
+		break;
+	case OUTPUT_CSV:
+		printf("%s,%u,%s,%s,%s,%u,%.1f\n",
+		       cur.sized->name, size, format, type, method->name,
+		       image_bytes, mb_per_sec);
+		break;
+	case OUTPUT_JSON:
+		printf("%s  {\"internalformat\": \"%s\", \"size\": %u, "
+		       "\"format\": \"%s\", \"type\": \"%s\", "
+		       "\"method\": \"%s\", \"bytes\": %u, "
+		       "\"mb_per_sec\": %.1f}",
+		       num_results ? ",\n" : "",
+		       cur.sized->name, size, format, type, method->name,
+		       image_bytes, mb_per_sec);
+		break;
+	}
+	num_results++;
+}
+
+/**
+ * Create the texture, FBO and PBOs for the current format and size.
+ * Returns false if the driver rejects the format.
+ */
+static bool
+setup_transfer(bool *fbo_complete)
+{
+	piglit_reset_gl_error();
+
+	glGenTextures(1, &tex);
+	glBindTexture(GL_TEXTURE_2D, tex);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	if (cur.compressed) {
+		image_bytes = (size / 4) * (size / 4) * cur.block_bytes;
+		client_data = calloc(1, image_bytes);
+		glCompressedTexImage2D(GL_TEXTURE_2D, 0, cur.sized->token,
+				       size, size, 0, image_bytes,
+				       client_data);
+	} else {
+		image_bytes = size * size * cur.bytes_per_pixel;
+		client_data = calloc(1, image_bytes);
+		glTexImage2D(GL_TEXTURE_2D, 0, cur.sized->token, size, size,
+			     0, cur.format, cur.type, client_data);
+	}
+
+	if (glGetError() != GL_NO_ERROR) {
+		glDeleteTextures(1, &tex);
+		free(client_data);
+		return false;
+	}
+
+	glGenBuffers(1, &unpack_pbo);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, unpack_pbo);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, image_bytes, client_data,
+		     GL_STREAM_DRAW);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	glGenBuffers(1, &pack_pbo);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, pack_pbo);
+	glBufferData(GL_PIXEL_PACK_BUFFER, image_bytes, NULL,
+		     GL_STREAM_READ);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	*fbo_complete = false;
+	if (!cur.compressed) {
+		glGenFramebuffers(1, &fbo);
+		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, cur.attachment,
+				       GL_TEXTURE_2D, tex, 0);
+		if (cur.attachment == GL_COLOR_ATTACHMENT0) {
+			glReadBuffer(GL_COLOR_ATTACHMENT0);
+		} else {
+			glDrawBuffer(GL_NONE);
+			glReadBuffer(GL_NONE);
+		}
+		*fbo_complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) ==
+				GL_FRAMEBUFFER_COMPLETE;
+	}
+
+	/* Errors from incomplete framebuffers etc. are not interesting. */
+	piglit_reset_gl_error();
+	return true;
+}
+
+static void
+teardown_transfer(void)
+{
+	if (fbo) {
+		glBindFramebuffer(GL_FRAMEBUFFER, piglit_winsys_fbo);
+		glDeleteFramebuffers(1, &fbo);
+		fbo = 0;
+	}
+	glDeleteBuffers(1, &unpack_pbo);
+	glDeleteBuffers(1, &pack_pbo);
+	glDeleteTextures(1, &tex);
+	free(client_data);
+}
+
+static void
+perf_run_format(void)
+{
+	GLint max_texture_size;
+	unsigned m;
+
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
+
+	for (size = min_size; size <= MIN2(max_size, (unsigned) max_texture_size);
+	     size *= 4) {
+		bool fbo_complete;
+
+		if (!setup_transfer(&fbo_complete)) {
+			if (output == OUTPUT_TEXT) {
+				printf("  %-28s unsupported\n",
+				       cur.sized->name);
+			}
+			return;
+		}
+
+		for (m = 0; m < ARRAY_SIZE(methods); m++) {
+			double rate;
+
+			if (methods[m].compressed != cur.compressed ||
+			    (methods[m].needs_fbo && !fbo_complete))
+				continue;
+
+			rate = perf_measure_rate(methods[m].func);
+			if (glGetError() != GL_NO_ERROR)
+				continue;
+
+			print_result(&methods[m],
+				     rate * image_bytes / 1000000.0);
+		}
+
+		teardown_transfer();
+	}
+}
+
+void
+piglit_init(int argc, char **argv)
+{
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-csv")) {
+			output = OUTPUT_CSV;
+		} else if (!strcmp(argv[i], "-json")) {
+			output = OUTPUT_JSON;
+		} else if (!strcmp(argv[i], "-convert")) {
+			convert = true;
+		} else if (!strcmp(argv[i], "-format") && i + 1 < argc) {
+			format_filter = argv[++i];
+		} else if (!strcmp(argv[i], "-min-size") && i + 1 < argc) {
+			min_size = MAX2(strtoul(argv[++i], NULL, 0), 4);
+		} else if (!strcmp(argv[i], "-max-size") && i + 1 < argc) {
+			max_size = strtoul(argv[++i], NULL, 0);
+		} else {
+			printf("usage: %s [-csv | -json] [-format GL_xxx] "
+			       "[-convert] [-min-size N] [-max-size N]\n",
+			       argv[0]);
+			piglit_report_result(PIGLIT_FAIL);
+		}
+	}
+
+	piglit_require_gl_version(30);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+}
+
+/** Called from test harness/main */
+enum piglit_result
+piglit_display(void)
+{
+	static const GLenum convert_types[] = {
+		GL_UNSIGNED_BYTE,
+		GL_FLOAT,
+	};
+	unsigned i, j;
+
+	if (output == OUTPUT_TEXT)
+		puts("Texture transfer throughput:");
+	else if (output == OUTPUT_CSV)
+		puts("internalformat,size,format,type,method,bytes,mb_per_sec");
+	else
+		puts("[");
+
+	for (i = 0; required_formats[i].token != GL_NONE; i++) {
+		const struct sized_internalformat *f =
+			get_sized_internalformat(required_formats[i].token);
+		GLenum channel_type;
+
+		if (!valid_for_gl_version(&required_formats[i],
+					  piglit_get_gl_version()))
+			continue;
+
+		if (format_filter && strcmp(format_filter, f->name) != 0)
+			continue;
+
+		if (!get_transfer_format(f, &cur))
+			continue;
+
+		perf_run_format();
+
+		/* Conversions are only defined for non-integer color. */
+		channel_type = get_channel_type(f, R);
+		if (!convert || cur.compressed ||
+		    cur.attachment != GL_COLOR_ATTACHMENT0 ||
+		    channel_type == GL_INT || channel_type == GL_UNSIGNED_INT)
+			continue;
+
+		for (j = 0; j < ARRAY_SIZE(convert_types); j++) {
+			if (cur.format == GL_RGBA &&
+			    cur.type == convert_types[j])
+				continue;
+
+			cur.format = GL_RGBA;
+			cur.type = convert_types[j];
+			cur.bytes_per_pixel = 4 * get_type_size(cur.type);
+			perf_run_format();
+		}
+	}
+
+	if (output == OUTPUT_JSON)
+		puts("\n]");
+
+	exit(0);
+	return PIGLIT_SKIP;
+}
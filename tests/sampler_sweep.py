@@ -0,0 +1,38 @@
+# -*- coding: utf-8 -*-
+#
+# The texelFetch, textureSize and textureSamples tests in sweep mode: one
+# process per test and GLSL version, instead of one per stage and sampler,
+# reporting every stage and sampler as a subtest.  all.py keeps running them
+# one per process, so their results keep their names there.
+
+from __future__ import (
+    absolute_import, division, print_function, unicode_literals
+)
+
+from framework import grouptools
+from framework.profile import TestProfile
+from framework.test import PiglitGLTest
+
+__all__ = ['profile']
+
+profile = TestProfile()  # pylint: disable=invalid-name
+
+# The sample counts all.py tests textureSamples with.
+MSAA_SAMPLE_COUNTS = ['2', '4', '6', '8', '16', '32']
+
+for version, extra in (('1.30', []), ('1.40', ['140'])):
+    with profile.test_list.group_manager(
+            PiglitGLTest,
+            grouptools.join('spec', 'glsl-{}'.format(version),
+                            'execution')) as g:
+        g(['texelFetch'] + extra + ['sweep'], 'texelFetch-sweep')
+        g(['texelFetch'] + extra + ['offset', 'sweep'],
+          'texelFetchOffset-sweep')
+        g(['textureSize'] + extra + ['sweep'], 'textureSize-sweep')
+
+with profile.test_list.group_manager(
+        PiglitGLTest,
+        grouptools.join('spec', 'arb_shader_texture_image_samples')) as g:
+    for sample_count in MSAA_SAMPLE_COUNTS:
+        g(['textureSamples', 'sweep', sample_count],
+          'textureSamples-sweep-{}'.format(sample_count))
@@ -24,10 +24,12 @@
 #include <stdbool.h>
 #include <string.h>
 #include <ctype.h>
+#include <inttypes.h>
 
 #include "piglit-util.h"
 #include "piglit-util-gl.h"
 #include "piglit-vbo.h"
+#include "piglit-caps.h"
 #include "piglit-framework-gl/piglit_gl_framework.h"
 
 #include "shader_runner_gles_workarounds.h"
@@ -41,6 +43,10 @@ static struct piglit_gl_test_config current_config;
 static void
 get_required_config(const char *script_name,
 		    struct piglit_gl_test_config *config);
+static bool
+caps_predict_skip(const char *script_name);
+static bool
+has_arg(int argc, char **argv, const char *arg);
 static GLenum
 decode_drawing_mode(const char *mode_str);
 
@@ -51,10 +57,18 @@ PIGLIT_GL_TEST_CONFIG_BEGIN
 	config.window_visual = PIGLIT_GL_VISUAL_RGBA | PIGLIT_GL_VISUAL_DOUBLE;
 	config.khr_no_error_support = PIGLIT_NO_ERRORS;
 
-	if (argc > 1)
+	if (argc > 1) {
 		get_required_config(argv[1], &config);
-	else
+
+		/* A batch can't skip as a whole, piglit_init() checks each
+		 * of its tests instead.
+		 */
+		if (!has_arg(argc, argv, "-report-subtests") &&
+		    caps_predict_skip(argv[1]))
+			piglit_report_result(PIGLIT_SKIP);
+	} else {
 		config.supports_gl_compat_version = 10;
+	}
 
 	current_config = config;
 
@@ -147,6 +161,23 @@ static GLint read_width, read_height;
 
 static bool report_subtests = false;
 
+/* Number of times the [test] section is replayed in -benchmark mode. */
+static unsigned benchmark_iterations = 0;
+static bool benchmark_pass = false;
+static bool benchmark_gpu_timing = false;
+
+static struct benchmark_command {
+	unsigned line_num;
+	char *text;
+	GLuint queries[2];
+	int64_t cpu_start;
+	int64_t *cpu_ns;
+	int64_t *gpu_ns;
+	unsigned num_samples;
+} *benchmark_commands;
+static unsigned num_benchmark_commands = 0;
+static unsigned benchmark_command_index = 0;
+
 static struct texture_binding {
 	GLuint obj;
 	unsigned width;
@@ -726,6 +757,41 @@ parse_version_comparison(const char *line, enum comparison *cmp,
 	version_init(v, tag, core, es, full_num);
 }
 
+/**
+ * Limits that the requirement section can compare against by name.
+ */
+static const struct {
+	const char *name;
+	int *val;
+	const char *desc;
+} getint_limits[] = {
+	{
+		"GL_MAX_VERTEX_OUTPUT_COMPONENTS",
+		&gl_max_vertex_output_components,
+		"vertex output components",
+	},
+	{
+		"GL_MAX_FRAGMENT_UNIFORM_COMPONENTS",
+		&gl_max_fragment_uniform_components,
+		"fragment uniform components",
+	},
+	{
+		"GL_MAX_VERTEX_UNIFORM_COMPONENTS",
+		&gl_max_vertex_uniform_components,
+		"vertex uniform components",
+	},
+	{
+		"GL_MAX_VERTEX_ATTRIBS",
+		&gl_max_vertex_attribs,
+		"vertex attribs",
+	},
+	{
+		"GL_MAX_VARYING_COMPONENTS",
+		&gl_max_varying_components,
+		"varying components",
+	},
+};
+
 /**
  * Parse and check a line from the requirement section of the test
  */
@@ -733,37 +799,6 @@ static enum piglit_result
 process_requirement(const char *line)
 {
 	char buffer[4096];
-	static const struct {
-		const char *name;
-		int *val;
-		const char *desc;
-	} getint_limits[] = {
-		{
-			"GL_MAX_VERTEX_OUTPUT_COMPONENTS",
-			&gl_max_vertex_output_components,
-			"vertex output components",
-		},
-		{
-			"GL_MAX_FRAGMENT_UNIFORM_COMPONENTS",
-			&gl_max_fragment_uniform_components,
-			"fragment uniform components",
-		},
-		{
-			"GL_MAX_VERTEX_UNIFORM_COMPONENTS",
-			&gl_max_vertex_uniform_components,
-			"vertex uniform components",
-		},
-		{
-			"GL_MAX_VERTEX_ATTRIBS",
-			&gl_max_vertex_attribs,
-			"vertex attribs",
-		},
-		{
-			"GL_MAX_VARYING_COMPONENTS",
-			&gl_max_varying_components,
-			"varying components",
-		},
-	};
 	unsigned i;
 
 	/* The INT keyword in the requirements section causes
@@ -1151,12 +1186,15 @@ cleanup:
 }
 
 
+static char *
+take_script_text(const char *script_name, unsigned *text_size);
+
 static enum piglit_result
 process_test_script(const char *script_name)
 {
 	unsigned text_size;
 	unsigned line_num;
-	char *text = piglit_load_text_file(script_name, &text_size);
+	char *text = take_script_text(script_name, &text_size);
 	enum states state = none;
 	const char *line = text;
 	enum piglit_result result;
@@ -1281,15 +1319,53 @@ struct requirement_parse_results {
 	unsigned size[2];
 };
 
+/**
+ * The last script scanned by parse_required_config().  Each script in a
+ * -report-subtests batch is scanned up to three times (the config in
+ * main(), validate_current_gl_context() and the test itself), so keep the
+ * text and the scan results around instead of reading the file again.
+ * process_test_script() takes the text over with take_script_text().
+ */
+static struct {
+	char *script_name;
+	char *text;
+	unsigned text_size;
+	struct requirement_parse_results results;
+} scanned_script;
+
+static char *
+take_script_text(const char *script_name, unsigned *text_size)
+{
+	char *text;
+
+	if (scanned_script.text == NULL ||
+	    strcmp(scanned_script.script_name, script_name) != 0)
+		return piglit_load_text_file(script_name, text_size);
+
+	text = scanned_script.text;
+	*text_size = scanned_script.text_size;
+	scanned_script.text = NULL;
+	return text;
+}
+
 static void
 parse_required_config(struct requirement_parse_results *results,
 		      const char *script_name)
 {
 	unsigned text_size;
-	char *text = piglit_load_text_file(script_name, &text_size);
-	const char *line = text;
+	char *text;
+	const char *line;
 	bool in_requirement_section = false;
 
+	if (scanned_script.script_name &&
+	    strcmp(scanned_script.script_name, script_name) == 0) {
+		*results = scanned_script.results;
+		return;
+	}
+
+	text = piglit_load_text_file(script_name, &text_size);
+	line = text;
+
 	results->found_gl = false;
 	results->found_glsl = false;
 	results->found_size = false;
@@ -1351,8 +1427,6 @@ parse_required_config(struct requirement_parse_results *results,
 			line++;
 	}
 
-	free(text);
-
 	if (!in_requirement_section) {
 		printf("[require] section missing\n");
 		piglit_report_result(PIGLIT_FAIL);
@@ -1363,6 +1437,13 @@ parse_required_config(struct requirement_parse_results *results,
 		       "but specifies no GL requirement\n.");
 		piglit_report_result(PIGLIT_FAIL);
 	}
+
+	free(scanned_script.script_name);
+	free(scanned_script.text);
+	scanned_script.script_name = strdup(script_name);
+	scanned_script.text = text;
+	scanned_script.text_size = text_size;
+	scanned_script.results = *results;
 }
 
 
@@ -1432,6 +1513,193 @@ get_required_config(const char *script_name,
 	}
 }
 
+/**
+ * Check one line of a requirement section against the capability snapshot
+ * of a context.  Returns false, after saying why, if the requirement is
+ * known to be unmet.  Anything the snapshot can't answer counts as met,
+ * process_requirement() checks it again once there is a context.
+ */
+static bool
+caps_meet_requirement(const struct piglit_caps *caps, const char *line)
+{
+	const bool core = strcmp(caps->profile, "core") == 0;
+	struct component_version caps_gl_version, caps_glsl_version;
+	char buffer[4096];
+	unsigned i;
+
+	version_init(&caps_gl_version, VERSION_GL, core, caps->es,
+		     caps->gl_version);
+	version_init(&caps_glsl_version, VERSION_GLSL, core, caps->glsl_es,
+		     caps->glsl_version);
+
+	if (parse_str(line, "INT ", &line)) {
+		enum comparison cmp;
+		int comparison_value, value;
+		unsigned int_enum;
+		const char *name;
+
+		if (!parse_enum_gl(line, &int_enum, &line) ||
+		    !parse_comparison_op(line, &cmp, &line) ||
+		    !parse_int(line, &comparison_value, &line))
+			return true;
+
+		name = piglit_get_gl_enum_name(int_enum);
+		if (piglit_caps_get_integer(caps, name, &value) &&
+		    !compare(comparison_value, value, cmp)) {
+			printf("Test requires %s %s %i.  "
+			       "The %s snapshot has %i.\n",
+			       name, comparison_string(cmp), comparison_value,
+			       caps->profile, value);
+			return false;
+		}
+		return true;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(getint_limits); i++) {
+		enum comparison cmp;
+		int maxcomp, value;
+
+		if (!parse_str(line, getint_limits[i].name, &line))
+			continue;
+
+		/* GLES reports these as vectors, shader_runner multiplies
+		 * them out itself.
+		 */
+		if (caps->es ||
+		    !parse_comparison_op(line, &cmp, &line) ||
+		    !piglit_caps_get_integer(caps, getint_limits[i].name,
+					     &value))
+			return true;
+
+		maxcomp = atoi(line);
+		if (!compare(maxcomp, value, cmp)) {
+			printf("Test requires %s %s %i.  "
+			       "The %s snapshot has %i.\n",
+			       getint_limits[i].desc, comparison_string(cmp),
+			       maxcomp, caps->profile, value);
+			return false;
+		}
+		return true;
+	}
+
+	if (parse_str(line, "GL_", NULL) &&
+	    parse_word_copy(line, buffer, sizeof(buffer), &line)) {
+		if (!piglit_caps_has_extension(caps, buffer)) {
+			printf("Test requires %s, which the %s snapshot "
+			       "lacks.\n", buffer, caps->profile);
+			return false;
+		}
+	} else if (parse_str(line, "!", &line) &&
+		   parse_str(line, "GL_", NULL) &&
+		   parse_word_copy(line, buffer, sizeof(buffer), &line)) {
+		if (piglit_caps_has_extension(caps, buffer)) {
+			printf("Test requires that %s is not supported, "
+			       "the %s snapshot has it.\n",
+			       buffer, caps->profile);
+			return false;
+		}
+	} else if (parse_str(line, "GLSL", &line)) {
+		enum comparison cmp;
+		struct component_version req_version;
+
+		parse_version_comparison(line, &cmp, &req_version,
+					 VERSION_GLSL);
+		if (cmp == greater_equal &&
+		    !version_compare(&req_version, &caps_glsl_version, cmp)) {
+			printf("Test requires %s %s.  "
+			       "The %s snapshot has %s.\n",
+			       comparison_string(cmp),
+			       version_string(&req_version), caps->profile,
+			       version_string(&caps_glsl_version));
+			return false;
+		}
+	} else if (parse_str(line, "GL", &line)) {
+		enum comparison cmp;
+		struct component_version req_version;
+
+		parse_version_comparison(line, &cmp, &req_version,
+					 VERSION_GL);
+		if (!version_compare(&req_version, &caps_gl_version, cmp)) {
+			printf("Test requires %s %s.  "
+			       "The %s snapshot has %s.\n",
+			       comparison_string(cmp),
+			       version_string(&req_version), caps->profile,
+			       version_string(&caps_gl_version));
+			return false;
+		}
+	} else if (parse_str(line, "SSO", &line) &&
+		   parse_str(line, "ENABLED", NULL)) {
+		const char *const ext_name = caps->es
+			? "GL_EXT_separate_shader_objects"
+			: "GL_ARB_separate_shader_objects";
+		const int min_version = caps->es ? 31 : 41;
+
+		if (caps->gl_version < min_version &&
+		    !piglit_caps_has_extension(caps, ext_name)) {
+			printf("Test requires %s, which the %s snapshot "
+			       "lacks.\n", ext_name, caps->profile);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Decide from the capability snapshots in PIGLIT_CAPS_DIR whether
+ * \p script_name would skip on every context the framework may create for
+ * it, so that it can skip without creating one.  Returns false whenever a
+ * snapshot is missing.
+ */
+static bool
+caps_predict_skip(const char *script_name)
+{
+	struct piglit_gl_test_config config = { 0 };
+	struct piglit_caps_candidate candidates[2];
+	const char *text, *line;
+	int count, i;
+
+	get_required_config(script_name, &config);
+	count = piglit_caps_for_config(&config, candidates);
+	if (count < 0)
+		return false;
+	if (count == 0) {
+		printf("No snapshot supports the required GL version.\n");
+		return true;
+	}
+
+	/* get_required_config() left the script in scanned_script. */
+	text = scanned_script.text;
+	if (text == NULL)
+		return false;
+
+	for (i = 0; i < count; i++) {
+		bool in_requirement_section = false;
+		bool met = true;
+
+		for (line = text; met && line[0] != '\0'; ) {
+			if (line[0] == '[') {
+				if (in_requirement_section)
+					break;
+				in_requirement_section =
+					parse_str(line, "[require]", NULL);
+			} else if (in_requirement_section) {
+				met = caps_meet_requirement(candidates[i].caps,
+							    line);
+			}
+
+			line = strchrnul(line, '\n');
+			if (line[0] != '\0')
+				line++;
+		}
+
+		if (met)
+			return false;
+	}
+
+	return true;
+}
+
 /**
  * Check that the GL implementation supports unsigned uniforms
  * (e.g. through glUniform1ui).  If not, terminate the test with a
@@ -2897,8 +3165,195 @@ probe_ssbo_uint(GLint ssbo_index, GLint ssbo_offset, const char *op, uint32_t va
 	return true;
 }
 
-enum piglit_result
-piglit_display(void)
+/**
+ * Commands whose cost is measured in -benchmark mode.
+ */
+static bool
+is_benchmarked_command(const char *line)
+{
+	return parse_str(line, "draw ", NULL) ||
+	       parse_str(line, "compute ", NULL);
+}
+
+/**
+ * Commands skipped in -benchmark mode, since they only read back
+ * results that were already checked by the first run.
+ */
+static bool
+is_probe_command(const char *line)
+{
+	return parse_str(line, "probe ", NULL) ||
+	       parse_str(line, "relative probe ", NULL);
+}
+
+static void
+benchmark_begin_command(unsigned line_num, const char *line)
+{
+	struct benchmark_command *cmd;
+
+	if (benchmark_command_index == num_benchmark_commands) {
+		benchmark_commands =
+			realloc(benchmark_commands,
+				(num_benchmark_commands + 1) *
+				sizeof(*benchmark_commands));
+		cmd = &benchmark_commands[num_benchmark_commands++];
+		cmd->line_num = line_num;
+		cmd->text = strdup(line);
+		cmd->cpu_ns = calloc(benchmark_iterations, sizeof(int64_t));
+		cmd->gpu_ns = calloc(benchmark_iterations, sizeof(int64_t));
+		cmd->num_samples = 0;
+		if (benchmark_gpu_timing)
+			glGenQueries(2, cmd->queries);
+	}
+
+	cmd = &benchmark_commands[benchmark_command_index];
+	if (benchmark_gpu_timing)
+		glQueryCounter(cmd->queries[0], GL_TIMESTAMP);
+	cmd->cpu_start = piglit_time_get_nano();
+}
+
+static void
+benchmark_end_command(void)
+{
+	struct benchmark_command *cmd =
+		&benchmark_commands[benchmark_command_index++];
+
+	/* Without this the CPU time only covers queuing the command. */
+	glFinish();
+	cmd->cpu_ns[cmd->num_samples] = piglit_time_get_nano() - cmd->cpu_start;
+	if (benchmark_gpu_timing)
+		glQueryCounter(cmd->queries[1], GL_TIMESTAMP);
+	cmd->num_samples++;
+}
+
+/**
+ * Collect the GPU timestamps of the pass that just finished.  This is
+ * done once per pass so that the queries don't stall the commands
+ * being measured.
+ */
+static void
+benchmark_resolve_gpu_times(void)
+{
+	unsigned i;
+
+	if (!benchmark_gpu_timing)
+		return;
+
+	for (i = 0; i < benchmark_command_index; i++) {
+		struct benchmark_command *cmd = &benchmark_commands[i];
+		GLuint64 t0, t1;
+
+		glGetQueryObjectui64v(cmd->queries[0], GL_QUERY_RESULT, &t0);
+		glGetQueryObjectui64v(cmd->queries[1], GL_QUERY_RESULT, &t1);
+		cmd->gpu_ns[cmd->num_samples - 1] = t1 - t0;
+	}
+}
+
+static int
+compare_int64(const void *a, const void *b)
+{
+	const int64_t x = *(const int64_t *) a;
+	const int64_t y = *(const int64_t *) b;
+
+	return x < y ? -1 : x > y;
+}
+
+/**
+ * Nearest-rank percentile of \p n samples.  Sorts \p samples in place.
+ */
+static int64_t
+percentile(int64_t *samples, unsigned n, unsigned pct)
+{
+	unsigned rank = (pct * n + 99) / 100;
+
+	qsort(samples, n, sizeof(*samples), compare_int64);
+	return samples[rank ? rank - 1 : 0];
+}
+
+static void
+print_json_string(const char *s)
+{
+	putchar('"');
+	for (; *s; s++) {
+		const unsigned char c = *s;
+
+		switch (c) {
+		case '"':
+		case '\\':
+			printf("\\%c", c);
+			break;
+		case '\t':
+			fputs("\\t", stdout);
+			break;
+		case '\n':
+			fputs("\\n", stdout);
+			break;
+		case '\r':
+			fputs("\\r", stdout);
+			break;
+		default:
+			if (c < 0x20)
+				printf("\\u%04x", c);
+			else
+				putchar(c);
+		}
+	}
+	putchar('"');
+}
+
+static void
+report_benchmark(void)
+{
+	unsigned i;
+
+	printf("PIGLIT: {\"benchmark\": {\"iterations\": %u, \"commands\": [",
+	       benchmark_iterations);
+	for (i = 0; i < num_benchmark_commands; i++) {
+		struct benchmark_command *cmd = &benchmark_commands[i];
+		unsigned n = cmd->num_samples;
+
+		printf("%s{\"line\": %u, \"command\": ", i ? ", " : "",
+		       cmd->line_num);
+		print_json_string(cmd->text);
+		printf(", \"cpu_median_ns\": %" PRId64
+		       ", \"cpu_p95_ns\": %" PRId64,
+		       percentile(cmd->cpu_ns, n, 50),
+		       percentile(cmd->cpu_ns, n, 95));
+		if (benchmark_gpu_timing) {
+			printf(", \"gpu_median_ns\": %" PRId64
+			       ", \"gpu_p95_ns\": %" PRId64 "}",
+			       percentile(cmd->gpu_ns, n, 50),
+			       percentile(cmd->gpu_ns, n, 95));
+		} else {
+			printf(", \"gpu_median_ns\": null"
+			       ", \"gpu_p95_ns\": null}");
+		}
+	}
+	printf("]}}\n");
+	fflush(stdout);
+}
+
+static void
+free_benchmark_commands(void)
+{
+	unsigned i;
+
+	for (i = 0; i < num_benchmark_commands; i++) {
+		struct benchmark_command *cmd = &benchmark_commands[i];
+
+		if (benchmark_gpu_timing)
+			glDeleteQueries(2, cmd->queries);
+		free(cmd->text);
+		free(cmd->cpu_ns);
+		free(cmd->gpu_ns);
+	}
+	free(benchmark_commands);
+	benchmark_commands = NULL;
+	num_benchmark_commands = 0;
+}
+
+static enum piglit_result
+run_test_section(void)
 {
 	const char *line, *next_line, *rest;
 	unsigned line_num;
@@ -2907,9 +3362,6 @@ piglit_display(void)
 	bool link_error_expected = false;
 	int ubo_array_index = 0;
 
-	if (test_start == NULL)
-		return PIGLIT_PASS;
-
 	next_line = test_start;
 	line_num = test_start_line_num;
 	while (next_line[0] != '\0') {
@@ -2919,6 +3371,7 @@ piglit_display(void)
 		unsigned ux, uy;
 		char s[300]; // 300 for safety
 		enum piglit_result result = PIGLIT_PASS;
+		bool benchmarked;
 
 		parse_whitespace(next_line, &line);
 
@@ -2931,6 +3384,16 @@ piglit_display(void)
 		if (next_line[0] != '\0')
 			next_line++;
 
+		if (benchmark_pass && is_probe_command(line)) {
+			free((void*) line);
+			line_num++;
+			continue;
+		}
+
+		benchmarked = benchmark_pass && is_benchmarked_command(line);
+		if (benchmarked)
+			benchmark_begin_command(line_num, line);
+
 		if (line[0] == '\0') {
 		} else if (sscanf(line, "active shader program %s", s) == 1) {
 			switch (get_shader_from_string(s, &x)) {
@@ -3495,7 +3958,9 @@ piglit_display(void)
 			glShadeModel(GL_FLAT);
 		} else if (sscanf(line, "ssbo %d %d", &x, &y) == 2) {
 			GLuint *ssbo_init = calloc(y, 1);
-			glGenBuffers(1, &ssbo[x]);
+			/* -benchmark replays this, reuse the buffer. */
+			if (!ssbo[x])
+				glGenBuffers(1, &ssbo[x]);
 			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, x, ssbo[x]);
 			glBufferData(GL_SHADER_STORAGE_BUFFER, y,
 				     ssbo_init, GL_DYNAMIC_DRAW);
@@ -3801,6 +4266,9 @@ piglit_display(void)
 			piglit_report_result(PIGLIT_FAIL);
 		}
 
+		if (benchmarked)
+			benchmark_end_command();
+
 		free((void*) line);
 
 		if (result != PIGLIT_PASS) {
@@ -3815,6 +4283,51 @@ piglit_display(void)
 		full_result = program_must_be_in_use();
 	}
 
+	return full_result;
+}
+
+/**
+ * Replay the [test] section benchmark_iterations times with probes
+ * skipped, timing each draw and compute command.
+ */
+static void
+run_benchmark(void)
+{
+	unsigned i;
+
+#ifdef PIGLIT_USE_OPENGL
+	benchmark_gpu_timing = piglit_get_gl_version() >= 33 ||
+		piglit_is_extension_supported("GL_ARB_timer_query");
+#else
+	benchmark_gpu_timing =
+		piglit_is_extension_supported("GL_EXT_disjoint_timer_query");
+#endif
+
+	benchmark_pass = true;
+	for (i = 0; i < benchmark_iterations; i++) {
+		benchmark_command_index = 0;
+		run_test_section();
+		benchmark_resolve_gpu_times();
+	}
+	benchmark_pass = false;
+
+	report_benchmark();
+	free_benchmark_commands();
+}
+
+enum piglit_result
+piglit_display(void)
+{
+	enum piglit_result full_result;
+
+	if (test_start == NULL)
+		return PIGLIT_PASS;
+
+	full_result = run_test_section();
+
+	if (benchmark_iterations && full_result == PIGLIT_PASS)
+		run_benchmark();
+
 	piglit_present_results();
 
 	if (piglit_automatic) {
@@ -3879,7 +4392,8 @@ static void
 recreate_gl_context(char *exec_arg, int param_argc, char **param_argv)
 {
 	int argc = param_argc + 4;
-	char **argv = malloc(sizeof(char*) * argc);
+	char **argv = malloc(sizeof(char*) * (argc + 2));
+	char iterations[16];
 
 	if (!argv) {
 		fprintf(stderr, "%s: malloc failed.\n", __func__);
@@ -3892,6 +4406,14 @@ recreate_gl_context(char *exec_arg, int param_argc, char **param_argv)
 	argv[argc-2] = "-fbo";
 	argv[argc-1] = "-report-subtests";
 
+	/* Keep benchmarking the remaining tests in the new context. */
+	if (benchmark_iterations) {
+		snprintf(iterations, sizeof(iterations), "%u",
+			 benchmark_iterations);
+		argv[argc++] = "-benchmark";
+		argv[argc++] = iterations;
+	}
+
 	if (gl_fw->destroy)
 		gl_fw->destroy(gl_fw);
 	gl_fw = NULL;
@@ -3899,6 +4421,40 @@ recreate_gl_context(char *exec_arg, int param_argc, char **param_argv)
 	exit(main(argc, argv));
 }
 
+static bool
+has_arg(int argc, char **argv, const char *arg)
+{
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], arg) == 0)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Derive the subtest name of a batched script from its file name.
+ */
+static void
+get_test_name(const char *filename, char *testname)
+{
+	const char *hit;
+	char *ext;
+
+	/* Strip the file path. */
+	hit = strrchr(filename, PIGLIT_PATH_SEP);
+	if (hit)
+		strcpy(testname, hit+1);
+	else
+		strcpy(testname, filename);
+
+	/* Strip the file extension. */
+	ext = strstr(testname, ".shader_test");
+	if (ext && !ext[12])
+		*ext = 0;
+}
+
 static bool
 validate_current_gl_context(const char *filename)
 {
@@ -3943,8 +4499,23 @@ piglit_init(int argc, char **argv)
 	float default_piglit_tolerance[4];
 
 	report_subtests = piglit_strip_arg(&argc, argv, "-report-subtests");
+	for (int i = 1; i < argc - 1; i++) {
+		if (strcmp(argv[i], "-benchmark") != 0)
+			continue;
+
+		benchmark_iterations = strtoul(argv[i + 1], NULL, 0);
+		if (benchmark_iterations == 0) {
+			printf("-benchmark requires a positive iteration count\n");
+			exit(1);
+		}
+		memmove(&argv[i], &argv[i + 2],
+			(argc - i - 2) * sizeof(char *));
+		argc -= 2;
+		break;
+	}
 	if (argc < 2) {
-		printf("usage: shader_runner <test.shader_test>\n");
+		printf("usage: shader_runner <test.shader_test> "
+		       "[-benchmark <iterations>]\n");
 		exit(1);
 	}
 
@@ -4004,15 +4575,28 @@ piglit_init(int argc, char **argv)
 
 	/* Automatic mode can run multiple tests per session. */
 	if (report_subtests) {
-		char testname[4096], *ext;
+		char testname[4096];
 		int i, j;
 
 		for (i = 1; i < argc; i++) {
-			const char *hit, *filename = argv[i];
+			const char *filename = argv[i];
 
 			memcpy(piglit_tolerance, default_piglit_tolerance,
 			       sizeof(piglit_tolerance));
 
+			/* Skip what the capability snapshots rule out before
+			 * possibly re-creating the context for it.
+			 */
+			if (caps_predict_skip(filename)) {
+				get_test_name(filename, testname);
+				printf("PIGLIT TEST: %i - %s\n", test_num, testname);
+				fprintf(stderr, "PIGLIT TEST: %i - %s\n", test_num, testname);
+				test_num++;
+				piglit_report_subtest_result(
+					PIGLIT_SKIP, "%s", testname);
+				continue;
+			}
+
 			/* Re-initialize the GL context if a different GL config is required. */
 			if (!validate_current_gl_context(filename))
 				recreate_gl_context(argv[0], argc - i, argv + i);
@@ -4134,17 +4718,7 @@ piglit_init(int argc, char **argv)
 
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-			/* Strip the file path. */
-			hit = strrchr(filename, PIGLIT_PATH_SEP);
-			if (hit)
-				strcpy(testname, hit+1);
-			else
-				strcpy(testname, filename);
-
-			/* Strip the file extension. */
-			ext = strstr(testname, ".shader_test");
-			if (ext && !ext[12])
-				*ext = 0;
+			get_test_name(filename, testname);
 
 			/* Print the name before we start the test, that way if
 			 * the test fails we can still resume and know which
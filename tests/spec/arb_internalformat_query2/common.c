@@ -496,10 +496,104 @@ create_texture(const GLenum target,
         }
         return result;
 }
+
+/*
+ * Textures created by test_data_check_against_get_tex_level_parameter,
+ * one per @target/@internalformat combination, along with the
+ * GetTexLevelParameter values already queried from them. The tests
+ * sweep the same combinations for several pnames, and for both the
+ * 32 and 64-bit queries, so the textures are kept until the process
+ * exits instead of being rebuilt for each check.
+ */
+struct level_param {
+        GLenum pname;
+        GLint value;
+};
+
+struct texture_cache_entry {
+        GLenum target;
+        GLenum internalformat;
+        /* False if create_texture failed (unsupported resource) */
+        bool created;
+        GLuint tex;
+        GLuint buffer;
+        unsigned num_params;
+        struct level_param params[8];
+        struct texture_cache_entry *next;
+};
+
+static struct texture_cache_entry *texture_cache[256];
+
+static struct texture_cache_entry *
+get_cached_texture(const GLenum target,
+                   const GLenum internalformat)
+{
+        struct texture_cache_entry **bucket =
+                &texture_cache[(target * 31 + internalformat) %
+                               ARRAY_SIZE(texture_cache)];
+        struct texture_cache_entry *entry;
+
+        for (entry = *bucket; entry; entry = entry->next) {
+                if (entry->target == target &&
+                    entry->internalformat == internalformat)
+                        return entry;
+        }
+
+        entry = calloc(1, sizeof(*entry));
+        entry->target = target;
+        entry->internalformat = internalformat;
+        entry->created = create_texture(target, internalformat,
+                                        &entry->tex, &entry->buffer);
+        entry->next = *bucket;
+        *bucket = entry;
+
+        return entry;
+}
+
+/*
+ * Queries @pname for level 0 of the texture of @entry, or returns
+ * the value from a previous query. Returns false on GL error.
+ */
+static bool
+get_cached_tex_level_parameter(struct texture_cache_entry *entry,
+                               const GLenum pname,
+                               GLint *param)
+{
+        GLenum real_target = entry->target;
+        unsigned i;
+
+        for (i = 0; i < entry->num_params; i++) {
+                if (entry->params[i].pname == pname) {
+                        *param = entry->params[i].value;
+                        return true;
+                }
+        }
+
+        /* For cube maps GetTexLevelParameter receives one of the face
+         * targets, or proxy */
+        if (entry->target == GL_TEXTURE_CUBE_MAP) {
+                real_target = GL_TEXTURE_CUBE_MAP_POSITIVE_X;
+        }
+        glBindTexture(entry->target, entry->tex);
+        glGetTexLevelParameteriv(real_target, 0, pname, param);
+        if (!piglit_check_gl_error(GL_NO_ERROR))
+                return false;
+
+        if (entry->num_params < ARRAY_SIZE(entry->params)) {
+                entry->params[entry->num_params].pname = pname;
+                entry->params[entry->num_params].value = *param;
+                entry->num_params++;
+        }
+
+        return true;
+}
+
 /*
  * Builds a a texture using @target and @internalformat, and compares
  * the result of calling GetTexLevelParameter using @pname with the
- * result included at @data.params.
+ * result included at @data.params. Both the texture and the
+ * GetTexLevelParameter result are cached for later checks of the same
+ * combination.
  *
  * At this point it is assumed that @target/@internalformat is a valid
  * combination to create a texture unless it is not supported by the
@@ -515,26 +609,17 @@ test_data_check_against_get_tex_level_parameter(test_data *data,
                                                 const GLenum pname,
                                                 const GLenum internalformat)
 {
+        struct texture_cache_entry *entry =
+                get_cached_texture(target, internalformat);
         GLint param;
-        bool result = true;
-        GLuint tex;
-        GLuint buffer;
-        GLenum real_target = target;
+        bool result;
 
-        result = create_texture(target, internalformat, &tex, &buffer);
-        if (!result)
+        if (!entry->created)
                 return test_data_is_unsupported_response(data, pname);
 
-        /* For cube maps GetTexLevelParameter receives one of the face
-         * targets, or proxy */
-        if (target == GL_TEXTURE_CUBE_MAP) {
-                real_target = GL_TEXTURE_CUBE_MAP_POSITIVE_X;
-        }
-        glGetTexLevelParameteriv(real_target, 0, pname, &param);
-        if (!piglit_check_gl_error(GL_NO_ERROR)) {
-                result = false;
+        if (!get_cached_tex_level_parameter(entry, pname, &param)) {
                 fprintf(stderr, "\tError calling glGetTexLevelParameter\n");
-                goto cleanup;
+                return false;
         }
 
         result = test_data_value_at_index(data, 0) == param;
@@ -546,10 +631,6 @@ test_data_check_against_get_tex_level_parameter(test_data *data,
                         test_data_value_at_index(data, 0), param);
         }
 
-cleanup:
-        glDeleteTextures(1, &tex);
-        glDeleteBuffers(1, &buffer);
-
         return result;
 }
 
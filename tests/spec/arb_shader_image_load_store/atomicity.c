@@ -139,7 +139,6 @@ run_test(uint32_t init_value, unsigned check_sz, uint32_t check_value,
                 check_image_const(img, check_sz, check_value) &&
                 (!check_unique || check_fb_unique(grid));
 
-        glDeleteProgram(prog);
         return ret;
 }
 
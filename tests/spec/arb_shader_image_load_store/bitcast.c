@@ -138,7 +138,6 @@ run_test(const struct image_format_info *src_format,
                 draw_grid(grid, prog) &&
                 check(grid, src_img, dst_img);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
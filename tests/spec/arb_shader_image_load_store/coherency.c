@@ -175,7 +175,6 @@ run_test(const struct image_qualifier_info *qual,
                 draw_grid(grid, prog) &&
                 (check(grid, img) || qual->control_test);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
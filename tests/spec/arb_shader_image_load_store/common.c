@@ -328,7 +328,6 @@ upload_image_levels(const struct image_info img, unsigned num_levels,
                         set_uniform_int(prog, "dst_img", unit) &&
                         draw_grid(grid, prog);
 
-                glDeleteProgram(prog);
                 glDeleteTextures(1, &tmp_tex);
 
                 glBindFramebuffer(GL_FRAMEBUFFER, fb[0]);
@@ -482,7 +481,6 @@ download_image_levels(const struct image_info img, unsigned num_levels,
                 glGetTexImage(GL_TEXTURE_2D, 0, img.format->pixel_format,
                               image_base_type(img.format), r_pixels);
 
-                glDeleteProgram(prog);
                 glDeleteTextures(1, &tmp_tex);
 
                 glBindFramebuffer(GL_FRAMEBUFFER, fb[0]);
@@ -503,17 +501,77 @@ bool
 init_pixels(const struct image_info img, uint32_t *r_pixels,
             double r, double g, double b, double a)
 {
-        const double init[4] = { r, g, b, a };
         const unsigned m = image_num_components(img.format);
+        const uint32_t init[4] = {
+                encode(img.format, r), encode(img.format, g),
+                encode(img.format, b), encode(img.format, a)
+        };
+        unsigned i;
+
+        for (i = 0; i < product(img.size); ++i)
+                memcpy(&r_pixels[i * m], init, sizeof(uint32_t) * m);
+
+        return true;
+}
+
+/**
+ * Find the first texel of \a pixels that doesn't match \a expect
+ * within the epsilon of \a img, skipping non-finite expected values.
+ * Returns the number of texels if they all match.
+ */
+static unsigned
+find_mismatch(const struct image_info img, unsigned stride,
+              const uint32_t *pixels, const uint32_t *expect)
+{
+        const unsigned m = image_num_components(img.format);
+        const unsigned n = product(img.size);
+        const GLenum base_type = image_base_type(img.format);
+        double epsilon[4];
+        bool exact = base_type != GL_FLOAT;
         unsigned i, j;
 
-        for (i = 0; i < product(img.size); ++i) {
-                for (j = 0; j < m; ++j) {
-                        r_pixels[i * m + j] = encode(img.format, init[j]);
+        for (j = 0; j < m; ++j) {
+                epsilon[j] = get_idx(img.epsilon, j);
+                exact &= epsilon[j] < 1.0;
+        }
+
+        if (exact) {
+                /* Integer values within less than one of each other
+                 * are equal, compare the words directly. */
+                if (stride && !memcmp(pixels, expect,
+                                      sizeof(uint32_t) * m * n))
+                        return n;
+
+                for (i = 0; i < n; ++i) {
+                        if (memcmp(&pixels[m * i], &expect[stride * m * i],
+                                   sizeof(uint32_t) * m))
+                                return i;
+                }
+        } else if (base_type == GL_FLOAT) {
+                for (i = 0; i < n; ++i) {
+                        const float *v = (const float *)&pixels[m * i];
+                        const float *u = (const float *)&expect[stride * m * i];
+
+                        for (j = 0; j < m; ++j) {
+                                if (fabs((double)v[j] - u[j]) > epsilon[j] &&
+                                    isfinite(u[j]))
+                                        return i;
+                        }
+                }
+        } else {
+                for (i = 0; i < n; ++i) {
+                        const uint32_t *v = &pixels[m * i];
+                        const uint32_t *u = &expect[stride * m * i];
+
+                        for (j = 0; j < m; ++j) {
+                                if (fabs(decode(img.format, v[j]) -
+                                         decode(img.format, u[j])) > epsilon[j])
+                                        return i;
+                        }
                 }
         }
 
-        return true;
+        return n;
 }
 
 static bool
@@ -521,39 +579,32 @@ check_pixels_vs(const struct image_info img, unsigned stride,
                 const uint32_t *pixels, const uint32_t *expect)
 {
         const unsigned m = image_num_components(img.format);
-        unsigned i, j;
+        const unsigned i = find_mismatch(img, stride, pixels, expect);
+        const uint32_t *v = &pixels[m * i];
+        const uint32_t *u = &expect[stride * m * i];
+        unsigned j;
 
-        for (i = 0; i < product(img.size); ++i) {
-                const uint32_t *v = &pixels[m * i];
-                const uint32_t *u = &expect[stride * m * i];
-
-                for (j = 0; j < m; ++j) {
-                        if ((fabs(decode(img.format, v[j]) - decode(img.format, u[j])) >
-                             get_idx(img.epsilon, j)) &&
-                            isfinite(decode(img.format, u[j]))) {
-                                printf("Probe value at (%u, %u, %u, %u)\n",
-                                       i % img.size.x,
-                                       i / img.size.x % img.size.y,
-                                       i / img.size.x / img.size.y % img.size.z,
-                                       i / img.size.x / img.size.y / img.size.z);
+        if (i == product(img.size))
+                return true;
 
-                                printf("  Expected:");
+        printf("Probe value at (%u, %u, %u, %u)\n",
+               i % img.size.x,
+               i / img.size.x % img.size.y,
+               i / img.size.x / img.size.y % img.size.z,
+               i / img.size.x / img.size.y / img.size.z);
 
-                                for (j = 0; j < m; ++j)
-                                        printf(" %f", decode(img.format, u[j]));
+        printf("  Expected:");
 
-                                printf("\n  Observed:");
+        for (j = 0; j < m; ++j)
+                printf(" %f", decode(img.format, u[j]));
 
-                                for (j = 0; j < m; ++j)
-                                        printf(" %f", decode(img.format, v[j]));
+        printf("\n  Observed:");
 
-                                printf("\n");
-                                return false;
-                        }
-                }
-        }
+        for (j = 0; j < m; ++j)
+                printf(" %f", decode(img.format, v[j]));
 
-        return true;
+        printf("\n");
+        return false;
 }
 
 bool
@@ -194,7 +194,6 @@ run_test(const struct image_op_info *op,
                 draw_grid(set_grid_size(grid, w, h), prog) &&
                 check(grid, img, w, h);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -160,7 +160,6 @@ run_test_image(const char *input_layout, GLenum depth_func,
                 check_img(img, expect_r, expect_g, expect_b, expect_a) &&
                 check_zb(expect_z);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -198,7 +197,6 @@ run_test_query(const char *input_layout, GLenum depth_func,
         ret &= check_query(q, expect_samples_passed);
 
         glDeleteQueries(1, &q);
-        glDeleteProgram(prog);
         return ret;
 }
 
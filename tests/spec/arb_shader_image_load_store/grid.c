@@ -32,20 +32,33 @@
 char *
 concat(char *hunk0, ...)
 {
-        char *s = hunk0;
-        char *hunk;
+        const size_t len0 = strlen(hunk0);
+        size_t len = len0;
+        char *s, *p, *hunk;
         va_list ap;
 
+        /* Size the result up front so that each hunk is copied only
+         * once, however many there are. */
         va_start(ap, hunk0);
+        while ((hunk = va_arg(ap, char *)))
+                len += 1 + strlen(hunk);
+        va_end(ap);
+
+        s = realloc(hunk0, len + 1);
+        p = s + len0;
 
+        va_start(ap, hunk0);
         while ((hunk = va_arg(ap, char *))) {
-                char *t = s;
-                (void)!asprintf(&s, "%s\n%s", t, hunk);
-                free(t);
+                const size_t n = strlen(hunk);
+
+                *p++ = '\n';
+                memcpy(p, hunk, n);
+                p += n;
                 free(hunk);
         }
-
         va_end(ap);
+
+        *p = '\0';
         return s;
 }
 
@@ -246,6 +259,156 @@ get_stage_idx(const struct image_stage_info *stage)
         return ffs(stage->bit) - 1;
 }
 
+/**
+ * Value a default block uniform had right after linking.
+ */
+struct uniform_default {
+        GLint loc;
+        bool is_uint;
+        GLint value;
+};
+
+/**
+ * Programs built by generate_program_v(), keyed on the source code of
+ * all their stages.  They live until the process exits.
+ */
+struct program_cache_entry {
+        char *key;
+        GLuint prog;
+        struct uniform_default *defaults;
+        unsigned num_defaults;
+        struct program_cache_entry *next;
+};
+
+static struct program_cache_entry *program_cache[256];
+
+static struct program_cache_entry **
+program_cache_bucket(const char *key)
+{
+        uint32_t h = 2166136261u;
+
+        for (; *key; key++)
+                h = (h ^ (unsigned char)*key) * 16777619u;
+
+        return &program_cache[h % ARRAY_SIZE(program_cache)];
+}
+
+static bool
+is_int_uniform_type(GLenum type)
+{
+        const char *name;
+
+        if (type == GL_INT || type == GL_BOOL)
+                return true;
+
+        /* Opaque types are set as integers (the unit). */
+        name = piglit_get_gl_enum_name(type);
+        return strstr(name, "SAMPLER") || strstr(name, "IMAGE");
+}
+
+/**
+ * Record the value of every default block uniform of \a prog in \a entry,
+ * so that reset_uniforms() can undo what callers set on it.  Returns false
+ * if \a prog has a uniform of a type callers can't set through
+ * set_uniform_int(), which is all the tests need.
+ */
+static bool
+record_uniform_defaults(GLuint prog, struct program_cache_entry *entry)
+{
+        GLint num_uniforms = 0, max_length = 0;
+        char *name, *element;
+        unsigned i;
+
+        glGetProgramiv(prog, GL_ACTIVE_UNIFORMS, &num_uniforms);
+        glGetProgramiv(prog, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+        name = malloc(max_length + 16);
+        element = malloc(max_length + 16);
+        entry->defaults = NULL;
+        entry->num_defaults = 0;
+
+        for (i = 0; i < num_uniforms; ++i) {
+                GLint size, block;
+                GLenum type;
+                char *bracket;
+                unsigned j;
+
+                glGetActiveUniform(prog, i, max_length + 16, NULL,
+                                   &size, &type, name);
+                glGetActiveUniformsiv(prog, 1, &i, GL_UNIFORM_BLOCK_INDEX,
+                                      &block);
+
+                /* Atomic counters and block members aren't uniform
+                 * state of the program. */
+                if (block >= 0 || type == GL_UNSIGNED_INT_ATOMIC_COUNTER)
+                        continue;
+
+                if (type != GL_UNSIGNED_INT && !is_int_uniform_type(type)) {
+                        free(entry->defaults);
+                        free(element);
+                        free(name);
+                        return false;
+                }
+
+                bracket = strchr(name, '[');
+                if (bracket)
+                        *bracket = '\0';
+
+                entry->defaults = realloc(
+                        entry->defaults, (entry->num_defaults + size) *
+                        sizeof(*entry->defaults));
+
+                for (j = 0; j < size; ++j) {
+                        struct uniform_default *d =
+                                &entry->defaults[entry->num_defaults++];
+
+                        if (bracket)
+                                sprintf(element, "%s[%u]", name, j);
+                        else
+                                strcpy(element, name);
+
+                        d->loc = glGetUniformLocation(prog, element);
+                        d->is_uint = (type == GL_UNSIGNED_INT);
+                        if (d->is_uint)
+                                glGetUniformuiv(prog, d->loc,
+                                                (GLuint *)&d->value);
+                        else
+                                glGetUniformiv(prog, d->loc, &d->value);
+                }
+        }
+
+        free(element);
+        free(name);
+        return true;
+}
+
+/**
+ * Give the uniforms of a cached program back the values they had right
+ * after linking.
+ */
+static void
+reset_uniforms(const struct program_cache_entry *entry)
+{
+        GLint last_prog;
+        unsigned i;
+
+        if (!entry->num_defaults)
+                return;
+
+        glGetIntegerv(GL_CURRENT_PROGRAM, &last_prog);
+        glUseProgram(entry->prog);
+
+        for (i = 0; i < entry->num_defaults; ++i) {
+                const struct uniform_default *d = &entry->defaults[i];
+
+                if (d->is_uint)
+                        glUniform1ui(d->loc, d->value);
+                else
+                        glUniform1i(d->loc, d->value);
+        }
+
+        glUseProgram(last_prog);
+}
+
 /**
  * Generate a full program pipeline using the shader code provided in
  * the \a sources array.
@@ -267,22 +430,47 @@ generate_program_v(const struct grid_info grid, const char **sources)
                  /* Make sure there is always a vertex and fragment
                   * shader if we're doing graphics. */
                  (grid.stages & graphic_stages ? basic_stages : 0));
-        GLuint prog = glCreateProgram();
+        char *stage_sources[6] = { NULL };
+        struct program_cache_entry **bucket, *entry;
         const struct image_stage_info *stage;
+        char *key = hunk("");
+        GLuint prog = 0;
+        unsigned i;
 
         for (stage = known_image_stages(); stage->stage; ++stage) {
                 if (stages & stage->bit) {
                         char *source = generate_stage_source(
                                 grid, stage->stage,
                                 sources[get_stage_idx(stage)]);
-                        GLuint shader = piglit_compile_shader_text_nothrow(
-                                stage->stage, source);
+                        char *tag = NULL;
+
+                        (void)!asprintf(&tag, "//stage %x", stage->stage);
+                        key = concat(key, tag, hunk(source), NULL);
+                        stage_sources[get_stage_idx(stage)] = source;
+                }
+        }
 
-                        free(source);
+        bucket = program_cache_bucket(key);
+        for (entry = *bucket; entry; entry = entry->next) {
+                if (!strcmp(entry->key, key)) {
+                        reset_uniforms(entry);
+                        prog = entry->prog;
+                        goto out;
+                }
+        }
+
+        prog = glCreateProgram();
+
+        for (stage = known_image_stages(); stage->stage; ++stage) {
+                if (stages & stage->bit) {
+                        GLuint shader = piglit_compile_shader_text_nothrow(
+                                stage->stage,
+                                stage_sources[get_stage_idx(stage)]);
 
                         if (!shader) {
                                 glDeleteProgram(prog);
-                                return 0;
+                                prog = 0;
+                                goto out;
                         }
 
                         glAttachShader(prog, shader);
@@ -296,9 +484,28 @@ generate_program_v(const struct grid_info grid, const char **sources)
 
         if (!piglit_link_check_status(prog)) {
                 glDeleteProgram(prog);
-                return 0;
+                prog = 0;
+                goto out;
         }
 
+        /* Programs whose uniforms can't be reset are handed out
+         * once, not shared. */
+        entry = malloc(sizeof(*entry));
+        if (!record_uniform_defaults(prog, entry)) {
+                free(entry);
+                goto out;
+        }
+
+        entry->key = key;
+        entry->prog = prog;
+        entry->next = *bucket;
+        *bucket = entry;
+        key = NULL;
+
+out:
+        for (i = 0; i < ARRAY_SIZE(stage_sources); ++i)
+                free(stage_sources[i]);
+        free(key);
         return prog;
 }
 
@@ -337,12 +544,13 @@ generate_program(const struct grid_info grid, ...)
 bool
 draw_grid(const struct grid_info grid, GLuint prog)
 {
-        static GLuint lprog;
+        GLint last_prog;
 
-        if (lprog != prog) {
+        /* Cached programs are shared, so another one may have been
+         * made current since this one was last drawn with. */
+        glGetIntegerv(GL_CURRENT_PROGRAM, &last_prog);
+        if ((GLuint)last_prog != prog)
                 glUseProgram(prog);
-                lprog = prog;
-        }
 
         if (grid.stages & GL_COMPUTE_SHADER_BIT) {
                 set_uniform_int(prog, "ret_img", max_image_units());
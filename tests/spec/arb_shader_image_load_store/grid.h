@@ -127,6 +127,14 @@ image_hunk(const struct image_info img, const char *prefix);
  *
  * The generated program will typically be passed as argument to
  * draw_grid() in order to launch the grid.
+ *
+ * Programs are cached for the lifetime of the process keyed on their
+ * generated source, so calls that generate the same source return the
+ * same program.  Its uniforms are reset to the values they had after
+ * linking each time it is returned, so callers can't see values set by
+ * a previous user, but two programs from the same source must not be
+ * used at the same time.  The caller must not delete the returned
+ * program.
  */
 GLuint
 generate_program(const struct grid_info grid, ...);
@@ -200,7 +200,6 @@ run_test_vertex_array_raw(const struct image_barrier_info *bar, unsigned l)
         ret &= piglit_check_gl_error(GL_NO_ERROR) &&
                 check_fb_green(grid);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -246,7 +245,6 @@ run_test_element_array_raw(const struct image_barrier_info *bar, unsigned l)
         ret &= piglit_check_gl_error(GL_NO_ERROR) &&
                 check_fb_green(grid);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -297,7 +295,6 @@ run_test_ubo_raw(const struct image_barrier_info *bar, unsigned l)
                 draw_grid(grid, prog) &&
                 check_fb_green(grid);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -341,7 +338,6 @@ run_test_tex_fetch_raw(const struct image_barrier_info *bar, unsigned l)
                 draw_grid(grid, prog) &&
                 check_fb_green(grid);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -377,7 +373,6 @@ run_test_image_raw(const struct image_barrier_info *bar, unsigned l)
                 draw_grid(grid, prog) &&
                 check_fb_green(grid);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -417,7 +412,6 @@ run_test_image_war(const struct image_barrier_info *bar, unsigned l)
                  * pass are green. */
                 check_img_green(img);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -465,7 +459,6 @@ run_test_indirect_raw(const struct image_barrier_info *bar, unsigned l)
         ret &= piglit_check_gl_error(GL_NO_ERROR) &&
                 check_fb_green(grid);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -513,7 +506,6 @@ run_test_pixel_raw(const struct image_barrier_info *bar, unsigned l)
                 check_pixels(img, pixels[0], 0, 1, 0, 1);
 
         glDeleteTextures(1, &tex);
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -563,7 +555,6 @@ run_test_pixel_waw(const struct image_barrier_info *bar, unsigned l)
                 check_img_green(img);
 
         glDeleteTextures(1, &tex);
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -599,7 +590,6 @@ run_test_tex_update_raw(const struct image_barrier_info *bar, unsigned l)
         ret &= piglit_check_gl_error(GL_NO_ERROR) &&
                 check_pixels(img, pixels[0], 0, 1, 0, 1);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -642,7 +632,6 @@ run_test_tex_update_waw(const struct image_barrier_info *bar, unsigned l)
         ret &= piglit_check_gl_error(GL_NO_ERROR) &&
                 check_img_green(img);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -678,7 +667,6 @@ run_test_buf_update_raw(const struct image_barrier_info *bar, unsigned l)
         ret &= piglit_check_gl_error(GL_NO_ERROR) &&
                 check_pixels(img, pixels[0], 0, 1, 0, 1);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -719,7 +707,6 @@ run_test_buf_update_waw(const struct image_barrier_info *bar, unsigned l)
         ret &= piglit_check_gl_error(GL_NO_ERROR) &&
                 check_img_green(img);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -764,7 +751,6 @@ run_test_fb_raw(const struct image_barrier_info *bar, unsigned l)
                 check_pixels(img, pixels[0], 0, 1, 0, 1);
 
         glDeleteFramebuffers(1, &fb);
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -812,7 +798,6 @@ run_test_fb_waw(const struct image_barrier_info *bar, unsigned l)
                 check_img_green(img);
 
         glDeleteFramebuffers(1, &fb);
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -874,7 +859,6 @@ run_test_xfb_waw(const struct image_barrier_info *bar, unsigned l)
                 check_img_green(img);
 
         glDeleteTransformFeedbacks(1, &xfb);
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -918,7 +902,6 @@ run_test_atom_raw(const struct image_barrier_info *bar, unsigned l)
                 draw_grid(grid, prog) &&
                 check_fb_green(grid);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -966,7 +949,6 @@ run_test_atom_war(const struct image_barrier_info *bar, unsigned l)
                  * pass are green. */
                 check_img_green(img);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -149,7 +149,6 @@ run_test(const struct image_stage_info *stage)
                 draw_grid(grid, prog) &&
                 check(grid, 5);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -329,7 +329,6 @@ run_test(const struct image_op_info *op,
                 draw_grid(grid, prog) &&
                 (check(grid, real_img) || control_test);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
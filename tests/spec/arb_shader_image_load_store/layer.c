@@ -190,7 +190,6 @@ run_test(const struct image_target_info *target,
                 draw_grid(grid, prog) &&
                 check(grid, real_img, (slices == 1 ? 0 : layer));
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -168,7 +168,6 @@ run_test(const struct image_target_info *target)
                 check_fb(grid, img, level) &&
                 check_img(img, level);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
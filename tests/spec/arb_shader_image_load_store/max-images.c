@@ -234,7 +234,6 @@ run_test(GLbitfield shaders)
                 draw_grid(grid, prog) &&
                 check(grid, img);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -109,7 +109,6 @@ run_test(const struct image_target_info *target,
                 draw_grid(grid, prog) &&
                 check(img);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -152,7 +152,6 @@ run_test(const struct image_qualifier_info *qual)
                 draw_grid(set_grid_size(grid, 1, 1), prog) &&
                 (check(img) || qual->control_test);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
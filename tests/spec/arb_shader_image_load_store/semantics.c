@@ -338,7 +338,6 @@ run_test(const struct image_op_info *op,
                 draw_grid(grid, prog) &&
                 check(op, grid, img);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -181,7 +181,6 @@ run_test(const struct image_test_info *test,
                 draw_grid(grid, prog) &&
                 (check(grid) || test->control_test);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
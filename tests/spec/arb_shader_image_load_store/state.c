@@ -466,7 +466,6 @@ run_test_uniform(void)
                         (loc, 1, GL_FALSE, (double *)v), ret);
         }
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -92,7 +92,6 @@ run_test(uint32_t init_value, uint32_t check_value,
                 draw_grid(grid, prog) &&
                 check(img, check_value);
 
-        glDeleteProgram(prog);
         return ret;
 }
 
@@ -157,7 +157,6 @@ run_test(const struct image_format_info *format,
 		draw_grid(grid, prog) &&
 		check(grid, img);
 
-	glDeleteProgram(prog);
 	return ret;
 }
 
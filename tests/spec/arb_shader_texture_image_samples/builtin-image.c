@@ -124,17 +124,14 @@ run_test(const struct image_format_info *format,
 		glBindTexture(img.target->target, tex);
 		glGetTexLevelParameteriv(img.target->target, 0,
 					 GL_TEXTURE_SAMPLES, &samples);
-		if (samples != size.x) {
-			glDeleteProgram(prog);
+		if (samples != size.x)
 			return PIGLIT_SKIP;
-		}
 	}
 	ret = ret &&
 		set_uniform_int(prog, "src_img", 0) &&
 		draw_grid(grid, prog) &&
 		check(grid, img);
 
-	glDeleteProgram(prog);
 	return ret ? PIGLIT_PASS : PIGLIT_FAIL;
 }
 
@@ -111,6 +111,7 @@ PIGLIT_GL_TEST_CONFIG_BEGIN
 	config.window_visual = PIGLIT_GL_VISUAL_RGB | PIGLIT_GL_VISUAL_DOUBLE;
 
 	config.subtests = subtests;
+	config.fork_subtests = true;
 
 PIGLIT_GL_TEST_CONFIG_END
 
@@ -170,6 +170,20 @@ compute_miplevel_info()
 	}
 }
 
+/**
+ * Free what compute_miplevel_info() allocated.
+ */
+void
+free_miplevel_info()
+{
+	int l;
+
+	for (l = 0; l < miplevels; l++)
+		free(level_size[l]);
+	free(level_size);
+	level_size = NULL;
+}
+
 bool
 has_height()
 {
@@ -209,6 +223,56 @@ is_shadow_sampler()
 	return sampler.format == GL_DEPTH_COMPONENT;
 }
 
+static const struct {
+	const char *name;
+	GLenum type;
+	GLenum target;
+} samplers[] = {
+	{ "sampler1D",              GL_SAMPLER_1D,                          GL_TEXTURE_1D,            },
+	{ "sampler2D",              GL_SAMPLER_2D,                          GL_TEXTURE_2D,            },
+	{ "sampler3D",              GL_SAMPLER_3D,                          GL_TEXTURE_3D,            },
+	{ "samplerCube",            GL_SAMPLER_CUBE,                        GL_TEXTURE_CUBE_MAP       },
+	{ "sampler2DRect",          GL_SAMPLER_2D_RECT,                     GL_TEXTURE_RECTANGLE      },
+	{ "sampler1DArray",         GL_SAMPLER_1D_ARRAY,                    GL_TEXTURE_1D_ARRAY       },
+	{ "sampler2DArray",         GL_SAMPLER_2D_ARRAY,                    GL_TEXTURE_2D_ARRAY       },
+	{ "samplerCubeArray",       GL_SAMPLER_CUBE_MAP_ARRAY,              GL_TEXTURE_CUBE_MAP_ARRAY },
+	{ "samplerBuffer",          GL_SAMPLER_BUFFER,                      GL_TEXTURE_BUFFER },
+	{ "sampler2DMS",            GL_SAMPLER_2D_MULTISAMPLE,              GL_TEXTURE_2D_MULTISAMPLE },
+	{ "sampler2DMSArray",       GL_SAMPLER_2D_MULTISAMPLE_ARRAY,        GL_TEXTURE_2D_MULTISAMPLE_ARRAY },
+
+	{ "sampler1DShadow",        GL_SAMPLER_1D_SHADOW,                   GL_TEXTURE_1D             },
+	{ "sampler2DShadow",        GL_SAMPLER_2D_SHADOW,                   GL_TEXTURE_2D             },
+	{ "samplerCubeShadow",      GL_SAMPLER_CUBE_SHADOW,                 GL_TEXTURE_CUBE_MAP       },
+	{ "sampler2DRectShadow",    GL_SAMPLER_2D_RECT_SHADOW,              GL_TEXTURE_RECTANGLE      },
+	{ "sampler1DArrayShadow",   GL_SAMPLER_1D_ARRAY_SHADOW,             GL_TEXTURE_1D_ARRAY       },
+	{ "sampler2DArrayShadow",   GL_SAMPLER_2D_ARRAY_SHADOW,             GL_TEXTURE_2D_ARRAY       },
+	{ "samplerCubeArrayShadow", GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW,       GL_TEXTURE_CUBE_MAP_ARRAY },
+
+	{ "isampler1D",             GL_INT_SAMPLER_1D,                      GL_TEXTURE_1D             },
+	{ "isampler2D",             GL_INT_SAMPLER_2D,                      GL_TEXTURE_2D             },
+	{ "isampler3D",             GL_INT_SAMPLER_3D,                      GL_TEXTURE_3D             },
+	{ "isamplerCube",           GL_INT_SAMPLER_CUBE,                    GL_TEXTURE_CUBE_MAP       },
+	{ "isampler2DRect",         GL_INT_SAMPLER_2D_RECT,                 GL_TEXTURE_RECTANGLE      },
+	{ "isampler1DArray",        GL_INT_SAMPLER_1D_ARRAY,                GL_TEXTURE_1D_ARRAY       },
+	{ "isampler2DArray",        GL_INT_SAMPLER_2D_ARRAY,                GL_TEXTURE_2D_ARRAY       },
+	{ "isamplerCubeArray",      GL_INT_SAMPLER_CUBE_MAP_ARRAY,          GL_TEXTURE_CUBE_MAP_ARRAY },
+	{ "isamplerBuffer",         GL_INT_SAMPLER_BUFFER,                  GL_TEXTURE_BUFFER },
+	{ "isampler2DMS",           GL_INT_SAMPLER_2D_MULTISAMPLE,          GL_TEXTURE_2D_MULTISAMPLE },
+	{ "isampler2DMSArray",      GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY,    GL_TEXTURE_2D_MULTISAMPLE_ARRAY },
+
+	{ "usampler1D",             GL_UNSIGNED_INT_SAMPLER_1D,             GL_TEXTURE_1D             },
+	{ "usampler2D",             GL_UNSIGNED_INT_SAMPLER_2D,             GL_TEXTURE_2D             },
+	{ "usampler3D",             GL_UNSIGNED_INT_SAMPLER_3D,             GL_TEXTURE_3D             },
+	{ "usamplerCube",           GL_UNSIGNED_INT_SAMPLER_CUBE,           GL_TEXTURE_CUBE_MAP       },
+	{ "usampler2DRect",         GL_UNSIGNED_INT_SAMPLER_2D_RECT,        GL_TEXTURE_RECTANGLE      },
+	{ "usampler1DArray",        GL_UNSIGNED_INT_SAMPLER_1D_ARRAY,       GL_TEXTURE_1D_ARRAY       },
+	{ "usampler2DArray",        GL_UNSIGNED_INT_SAMPLER_2D_ARRAY,       GL_TEXTURE_2D_ARRAY       },
+	{ "usamplerCubeArray",      GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY, GL_TEXTURE_CUBE_MAP_ARRAY },
+	{ "usamplerBuffer",         GL_UNSIGNED_INT_SAMPLER_BUFFER,         GL_TEXTURE_BUFFER },
+	{ "usampler2DMS",           GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE, GL_TEXTURE_2D_MULTISAMPLE },
+	{ "usampler2DMSArray",      GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY, GL_TEXTURE_2D_MULTISAMPLE_ARRAY },
+};
+
 /**
  * Check if a given command line argument is a valid GLSL sampler type.
  * If so, infer dimensionality and data format based on the name.
@@ -220,55 +284,6 @@ select_sampler(const char *name)
 {
 	int i;
 	bool found = false;
-	struct {
-		const char *name;
-		GLenum type;
-		GLenum target;
-	} samplers[] = {
-		{ "sampler1D",              GL_SAMPLER_1D,                          GL_TEXTURE_1D,            },
-		{ "sampler2D",              GL_SAMPLER_2D,                          GL_TEXTURE_2D,            },
-		{ "sampler3D",              GL_SAMPLER_3D,                          GL_TEXTURE_3D,            },
-		{ "samplerCube",            GL_SAMPLER_CUBE,                        GL_TEXTURE_CUBE_MAP       },
-		{ "sampler2DRect",          GL_SAMPLER_2D_RECT,                     GL_TEXTURE_RECTANGLE      },
-		{ "sampler1DArray",         GL_SAMPLER_1D_ARRAY,                    GL_TEXTURE_1D_ARRAY       },
-		{ "sampler2DArray",         GL_SAMPLER_2D_ARRAY,                    GL_TEXTURE_2D_ARRAY       },
-		{ "samplerCubeArray",       GL_SAMPLER_CUBE_MAP_ARRAY,              GL_TEXTURE_CUBE_MAP_ARRAY },
-		{ "samplerBuffer",          GL_SAMPLER_BUFFER,                      GL_TEXTURE_BUFFER },
-		{ "sampler2DMS",            GL_SAMPLER_2D_MULTISAMPLE,              GL_TEXTURE_2D_MULTISAMPLE },
-		{ "sampler2DMSArray",       GL_SAMPLER_2D_MULTISAMPLE_ARRAY,        GL_TEXTURE_2D_MULTISAMPLE_ARRAY },
-
-		{ "sampler1DShadow",        GL_SAMPLER_1D_SHADOW,                   GL_TEXTURE_1D             },
-		{ "sampler2DShadow",        GL_SAMPLER_2D_SHADOW,                   GL_TEXTURE_2D             },
-		{ "samplerCubeShadow",      GL_SAMPLER_CUBE_SHADOW,                 GL_TEXTURE_CUBE_MAP       },
-		{ "sampler2DRectShadow",    GL_SAMPLER_2D_RECT_SHADOW,              GL_TEXTURE_RECTANGLE      },
-		{ "sampler1DArrayShadow",   GL_SAMPLER_1D_ARRAY_SHADOW,             GL_TEXTURE_1D_ARRAY       },
-		{ "sampler2DArrayShadow",   GL_SAMPLER_2D_ARRAY_SHADOW,             GL_TEXTURE_2D_ARRAY       },
-		{ "samplerCubeArrayShadow", GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW,       GL_TEXTURE_CUBE_MAP_ARRAY },
-
-		{ "isampler1D",             GL_INT_SAMPLER_1D,                      GL_TEXTURE_1D             },
-		{ "isampler2D",             GL_INT_SAMPLER_2D,                      GL_TEXTURE_2D             },
-		{ "isampler3D",             GL_INT_SAMPLER_3D,                      GL_TEXTURE_3D             },
-		{ "isamplerCube",           GL_INT_SAMPLER_CUBE,                    GL_TEXTURE_CUBE_MAP       },
-		{ "isampler2DRect",         GL_INT_SAMPLER_2D_RECT,                 GL_TEXTURE_RECTANGLE      },
-		{ "isampler1DArray",        GL_INT_SAMPLER_1D_ARRAY,                GL_TEXTURE_1D_ARRAY       },
-		{ "isampler2DArray",        GL_INT_SAMPLER_2D_ARRAY,                GL_TEXTURE_2D_ARRAY       },
-		{ "isamplerCubeArray",      GL_INT_SAMPLER_CUBE_MAP_ARRAY,          GL_TEXTURE_CUBE_MAP_ARRAY },
-		{ "isamplerBuffer",         GL_INT_SAMPLER_BUFFER,                  GL_TEXTURE_BUFFER },
-		{ "isampler2DMS",           GL_INT_SAMPLER_2D_MULTISAMPLE,          GL_TEXTURE_2D_MULTISAMPLE },
-		{ "isampler2DMSArray",      GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY,    GL_TEXTURE_2D_MULTISAMPLE_ARRAY },
-
-		{ "usampler1D",             GL_UNSIGNED_INT_SAMPLER_1D,             GL_TEXTURE_1D             },
-		{ "usampler2D",             GL_UNSIGNED_INT_SAMPLER_2D,             GL_TEXTURE_2D             },
-		{ "usampler3D",             GL_UNSIGNED_INT_SAMPLER_3D,             GL_TEXTURE_3D             },
-		{ "usamplerCube",           GL_UNSIGNED_INT_SAMPLER_CUBE,           GL_TEXTURE_CUBE_MAP       },
-		{ "usampler2DRect",         GL_UNSIGNED_INT_SAMPLER_2D_RECT,        GL_TEXTURE_RECTANGLE      },
-		{ "usampler1DArray",        GL_UNSIGNED_INT_SAMPLER_1D_ARRAY,       GL_TEXTURE_1D_ARRAY       },
-		{ "usampler2DArray",        GL_UNSIGNED_INT_SAMPLER_2D_ARRAY,       GL_TEXTURE_2D_ARRAY       },
-		{ "usamplerCubeArray",      GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY, GL_TEXTURE_CUBE_MAP_ARRAY },
-		{ "usamplerBuffer",         GL_UNSIGNED_INT_SAMPLER_BUFFER,         GL_TEXTURE_BUFFER },
-		{ "usampler2DMS",           GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE, GL_TEXTURE_2D_MULTISAMPLE },
-		{ "usampler2DMSArray",      GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY, GL_TEXTURE_2D_MULTISAMPLE_ARRAY },
-	};
 
 	for (i = 0; i < ARRAY_SIZE(samplers); i++) {
 		if (strcmp(samplers[i].name, name) == 0) {
@@ -280,7 +295,7 @@ select_sampler(const char *name)
 	if (!found)
 		return false;
 
-	sampler.name = name;
+	sampler.name = samplers[i].name;
 	sampler.type = samplers[i].type;
 	sampler.target = samplers[i].target;
 
@@ -315,69 +330,119 @@ select_sampler(const char *name)
 	return true;
 }
 
+static bool
+check_gl_version(int version)
+{
+	if (piglit_get_gl_version() >= version)
+		return true;
+
+	printf("Test requires GL version %d.%d\n", version / 10, version % 10);
+	return false;
+}
+
+static bool
+check_extension(const char *name)
+{
+	if (piglit_is_extension_supported(name))
+		return true;
+
+	printf("Test requires %s\n", name);
+	return false;
+}
+
 /**
- * Ensures the driver supports the required extensions, GL, and GLSL versions.
- * If it doesn't, report PIGLIT_SKIP and exit the test.
+ * Checks that the driver supports the required extensions, GL, and GLSL
+ * versions.  Returns PIGLIT_SKIP if it doesn't.
  */
-void
-require_GL_features(enum shader_target test_stage)
+enum piglit_result
+check_GL_features(enum shader_target test_stage)
 {
+	bool es;
+	int major, minor;
 	int tex_units;
+	bool ok = true;
 
-	piglit_require_GLSL_version(shader_version);
+	piglit_get_glsl_version(&es, &major, &minor);
+	if (es || major * 100 + minor < shader_version) {
+		printf("GLSL %d.%d not supported.\n",
+		       shader_version / 100, shader_version % 100);
+		return PIGLIT_SKIP;
+	}
 
 	if (swizzling)
-		piglit_require_extension("GL_EXT_texture_swizzle");
+		ok = ok && check_extension("GL_EXT_texture_swizzle");
 
 	switch (sampler.internal_format) {
 	case GL_RGBA32I:
 	case GL_RGBA16I:
-		piglit_require_extension("GL_EXT_texture_integer");
+		ok = ok && check_extension("GL_EXT_texture_integer");
 		break;
 	case GL_RGBA32UI:
 	case GL_RGBA16UI:
 		if (piglit_is_extension_supported("GL_EXT_gpu_shader4"))
-			piglit_require_gl_version(21);
+			ok = ok && check_gl_version(21);
 		else
-			piglit_require_gl_version(30);
+			ok = ok && check_gl_version(30);
 		break;
 	case GL_RGBA32F:
 	case GL_RGBA16F:
-		piglit_require_extension("GL_ARB_texture_float");
+		ok = ok && check_extension("GL_ARB_texture_float");
 		break;
 	}
 
 	switch (sampler.target) {
 	case GL_TEXTURE_CUBE_MAP_ARRAY:
-		piglit_require_extension("GL_ARB_texture_cube_map_array");
+		ok = ok && check_extension("GL_ARB_texture_cube_map_array");
 		break;
 	case GL_TEXTURE_1D_ARRAY:
 	case GL_TEXTURE_2D_ARRAY:
-		piglit_require_extension("GL_EXT_texture_array");
+		ok = ok && check_extension("GL_EXT_texture_array");
 		break;
 	case GL_TEXTURE_CUBE_MAP:
 		if (is_shadow_sampler()) {
 			if (piglit_is_extension_supported("GL_EXT_gpu_shader4"))
-				piglit_require_gl_version(21);
+				ok = ok && check_gl_version(21);
 			else
-				piglit_require_gl_version(30);
+				ok = ok && check_gl_version(30);
 		}
 		break;
 	case GL_TEXTURE_RECTANGLE:
-		piglit_require_extension("GL_ARB_texture_rectangle");
+		ok = ok && check_extension("GL_ARB_texture_rectangle");
 		break;
 	case GL_TEXTURE_BUFFER:
-		piglit_require_extension("GL_ARB_texture_buffer_object");
+		ok = ok && check_extension("GL_ARB_texture_buffer_object");
 		break;
 	case GL_TEXTURE_2D_MULTISAMPLE:
 	case GL_TEXTURE_2D_MULTISAMPLE_ARRAY:
-		piglit_require_extension("GL_ARB_texture_multisample");
+		ok = ok && check_extension("GL_ARB_texture_multisample");
 	}
 
+	if (!ok)
+		return PIGLIT_SKIP;
+
 	/* If testing in the VS, check for VS texture units */
 	glGetIntegerv(GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS, &tex_units);
 	if (test_stage == VS && tex_units <= 0)
-		piglit_report_result(PIGLIT_SKIP);
+		return PIGLIT_SKIP;
+
+	/* Geometry shaders need GL 3.2. */
+	if (test_stage == GS && !check_gl_version(32))
+		return PIGLIT_SKIP;
+
+	return PIGLIT_PASS;
+}
+
+/**
+ * Ensures the driver supports the required extensions, GL, and GLSL versions.
+ * If it doesn't, report PIGLIT_SKIP and exit the test.
+ */
+void
+require_GL_features(enum shader_target test_stage)
+{
+	enum piglit_result result = check_GL_features(test_stage);
+
+	if (result != PIGLIT_PASS)
+		piglit_report_result(result);
 }
 
 /**
@@ -459,3 +524,130 @@ parse_swizzle(const char *swiz)
 
 	return true;
 }
+
+bool sweep_mode;
+
+/** Stages and samplers named on the command line after "sweep". */
+static bool sweep_stages[GS + 1];
+static int sweep_samplers[ARRAY_SIZE(samplers)];
+static int num_sweep_samplers;
+
+static const char *const stage_names[] = {
+	[VS] = "vs",
+	[FS] = "fs",
+	[GS] = "gs",
+};
+
+/**
+ * Parse an argument for sweep mode: "sweep" itself, and once it has been
+ * seen, stage and sampler names and the sample count for multisample
+ * samplers.  Returns \c true if \p arg was consumed.
+ */
+bool
+parse_sweep_arg(const char *arg)
+{
+	int i;
+
+	if (strcmp(arg, "sweep") == 0) {
+		sweep_mode = true;
+		return true;
+	}
+
+	if (!sweep_mode)
+		return false;
+
+	for (i = VS; i <= GS; i++) {
+		if (strcmp(arg, stage_names[i]) == 0) {
+			sweep_stages[i] = true;
+			return true;
+		}
+	}
+
+	for (i = 0; i < ARRAY_SIZE(samplers); i++) {
+		if (strcmp(arg, samplers[i].name) == 0) {
+			sweep_samplers[num_sweep_samplers++] = i;
+			return true;
+		}
+	}
+
+	if (strspn(arg, "0123456789") == strlen(arg) && atoi(arg) > 0) {
+		sample_count = atoi(arg);
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * Run \p sweep over the requested samplers and stages, see struct
+ * sampler_sweep.  The textures for a sampler are created once and tested
+ * in every stage, geometry shaders raise the GLSL version to 1.50.
+ */
+enum piglit_result
+run_sampler_sweep(const struct sampler_sweep *sweep)
+{
+	const int base_version = shader_version;
+	const enum shader_target order[] = { VS, GS, FS };
+	enum piglit_result result = PIGLIT_SKIP;
+	bool all_stages = true;
+	int i, s;
+
+	for (s = VS; s <= GS; s++)
+		if (sweep_stages[s])
+			all_stages = false;
+
+	if (num_sweep_samplers == 0) {
+		for (i = 0; i < ARRAY_SIZE(samplers); i++) {
+			select_sampler(samplers[i].name);
+			if (sweep->supported())
+				sweep_samplers[num_sweep_samplers++] = i;
+		}
+	}
+
+	for (i = 0; i < num_sweep_samplers; i++) {
+		enum piglit_result setup_result = PIGLIT_PASS;
+		bool set_up = false;
+
+		select_sampler(samplers[sweep_samplers[i]].name);
+
+		for (s = 0; s < ARRAY_SIZE(order); s++) {
+			const enum shader_target stage = order[s];
+			enum piglit_result subtest;
+
+			if (!all_stages && !sweep_stages[stage])
+				continue;
+
+			shader_version = stage == GS ?
+				MAX2(base_version, 150) : base_version;
+
+			subtest = check_GL_features(stage);
+			if (subtest == PIGLIT_PASS) {
+				/* Create the textures when the first stage
+				 * that can use them comes up.
+				 */
+				if (!set_up) {
+					setup_result = sweep->setup();
+					set_up = true;
+				}
+				subtest = setup_result;
+			}
+			if (subtest == PIGLIT_PASS)
+				subtest = sweep->run(stage);
+
+			piglit_report_subtest_result(subtest, "%s-%s-%s",
+						     stage_names[stage],
+						     sweep->test_name,
+						     sampler.name);
+			piglit_merge_result(&result, subtest);
+		}
+
+		if (set_up) {
+			sweep->teardown();
+			if (level_size)
+				free_miplevel_info();
+		}
+	}
+
+	shader_version = base_version;
+	return result;
+}
@@ -105,8 +105,42 @@ bool is_shadow_sampler();
 
 void swizzle(float vec4[]);
 
+/**
+ * Sweep mode, selected with the "sweep" argument: instead of one stage and
+ * sampler per process, run every requested sampler in every requested
+ * stage in one context and report each as the subtest
+ * "<stage>-<test name>-<sampler>".  Stages and samplers listed after
+ * "sweep" restrict the sweep, by default it covers all three stages and
+ * the samplers all.py lists for the test.
+ */
+struct sampler_sweep {
+	/** Test name used in subtest names, e.g. "texelFetch". */
+	const char *test_name;
+
+	/** Whether the current sampler is part of the default sweep. */
+	bool (*supported)(void);
+
+	/**
+	 * Create the textures for the current sampler.  They are shared by
+	 * every stage tested with it.
+	 */
+	enum piglit_result (*setup)(void);
+
+	/** Test the current sampler in \p stage. */
+	enum piglit_result (*run)(enum shader_target stage);
+
+	/** Free what setup() created. */
+	void (*teardown)(void);
+};
+
+extern bool sweep_mode;
+
 void upload_miplevel_data(GLenum target, int level, void *level_image);
 void compute_miplevel_info();
+void free_miplevel_info();
+enum piglit_result check_GL_features(enum shader_target test_stage);
 void require_GL_features(enum shader_target test_stage);
 bool select_sampler(const char *name);
 bool parse_swizzle(const char *swiz);
+bool parse_sweep_arg(const char *arg);
+enum piglit_result run_sampler_sweep(const struct sampler_sweep *sweep);
@@ -174,12 +174,23 @@ static bool test_once()
 							level_size[l][0],
 							level_size[l][1],
 							expected_colors[l][z]);
-			free(expected_colors[l][z]);
 		}
+	}
+	return pass;
+}
+
+static void
+free_expected_colors()
+{
+	int l, z;
+
+	for (l = 0; l < miplevels; l++) {
+		for (z = 0; z < level_size[l][2]; z++)
+			free(expected_colors[l][z]);
 		free(expected_colors[l]);
 	}
 	free(expected_colors);
-	return pass;
+	expected_colors = NULL;
 }
 
 /**
@@ -572,10 +583,16 @@ generate_GLSL(enum shader_target test_stage)
 	int vs, gs, fs, prog;
 
 	static char *vs_code;
-	static char *gs_code = NULL;
+	static char *gs_code;
 	static char *fs_code;
 	const char *offset_func, *offset_arg;
 
+	/* Don't let a GS from an earlier call leak into another stage. */
+	free(vs_code);
+	free(gs_code);
+	free(fs_code);
+	vs_code = gs_code = fs_code = NULL;
+
 	if (test_offset) {
 		offset_func = "Offset";
 		switch (sampler.target) {
@@ -729,19 +746,19 @@ generate_GLSL(enum shader_target test_stage)
 	vs = piglit_compile_shader_text(GL_VERTEX_SHADER, vs_code);
 	if (!vs) {
 		printf("VS code:\n%s", vs_code);
-		piglit_report_result(PIGLIT_FAIL);
+		return 0;
 	}
 	if (gs_code) {
 		gs = piglit_compile_shader_text(GL_GEOMETRY_SHADER, gs_code);
 		if (!gs) {
 			printf("GS code:\n%s", gs_code);
-			piglit_report_result(PIGLIT_FAIL);
+			return 0;
 		}
 	}
 	fs = piglit_compile_shader_text(GL_FRAGMENT_SHADER, fs_code);
 	if (!fs) {
 		printf("FS code:\n%s", fs_code);
-		piglit_report_result(PIGLIT_FAIL);
+		return 0;
 	}
 	prog = glCreateProgram();
 	glAttachShader(prog, vs);
@@ -753,8 +770,14 @@ generate_GLSL(enum shader_target test_stage)
 	glBindAttribLocation(prog, texcoord_loc, "texcoord");
 
 	glLinkProgram(prog);
-	if (!piglit_link_check_status(prog))
-		piglit_report_result(PIGLIT_FAIL);
+	glDeleteShader(vs);
+	if (gs_code)
+		glDeleteShader(gs);
+	glDeleteShader(fs);
+	if (!piglit_link_check_status(prog)) {
+		glDeleteProgram(prog);
+		return 0;
+	}
 
 	return prog;
 }
@@ -783,7 +806,9 @@ void
 fail_and_show_usage()
 {
 	printf("Usage: texelFetch [140] [offset] <vs|gs|fs> <sampler type> "
-	       "[sample_count] [swizzle] [piglit args...]\n");
+	       "[sample_count] [swizzle] [piglit args...]\n"
+	       "       texelFetch [140] [offset] sweep [vs|gs|fs...] "
+	       "[sampler types...] [sample_count] [swizzle] [size]\n");
 	piglit_report_result(PIGLIT_FAIL);
 }
 
@@ -801,7 +826,15 @@ parse_args(int argc, char **argv)
 	minz = maxz = 5;
 
 	for (i = 1; i < argc; i++) {
-		if (test_stage == UNKNOWN) {
+		if (strcmp(argv[i], "140") == 0) {
+			shader_version = 140;
+			continue;
+		}
+
+		if (parse_sweep_arg(argv[i]))
+			continue;
+
+		if (!sweep_mode && test_stage == UNKNOWN) {
 			/* Maybe it's the shader stage? */
 			if (strcmp(argv[i], "vs") == 0) {
 				test_stage = VS;
@@ -815,18 +848,14 @@ parse_args(int argc, char **argv)
 			}
 		}
 
-		if (strcmp(argv[i], "140") == 0) {
-			shader_version = 140;
-			continue;
-		}
-
 		if (strcmp(argv[i], "offset") == 0) {
 			test_offset = true;
 			continue;
 		}
 
 		/* Maybe it's the sampler type? */
-		if (!sampler_found && (sampler_found = select_sampler(argv[i])))
+		if (!sweep_mode && !sampler_found &&
+		    (sampler_found = select_sampler(argv[i])))
 			continue;
 
 		/* Maybe it's the sample count? */
@@ -874,6 +903,15 @@ parse_args(int argc, char **argv)
 		fail_and_show_usage();
 	}
 
+	if (sweep_mode) {
+		/* Every sampler is tested at one size, set up in
+		 * sweep_setup().
+		 */
+		if (minx < maxx || miny < maxy || minz < maxz)
+			fail_and_show_usage();
+		return;
+	}
+
 	if (test_stage == UNKNOWN || !sampler_found)
 		fail_and_show_usage();
 
@@ -933,6 +971,8 @@ piglit_display()
 				pass &= test_once();
 
 				glUseProgram(0);
+				free_expected_colors();
+				free_miplevel_info();
 				glDeleteTextures(1, &tex);
 				glDeleteBuffers(1, &pos_vbo);
 				glDeleteBuffers(1, &tc_vbo);
@@ -945,11 +985,145 @@ piglit_display()
 	return pass ? PIGLIT_PASS : PIGLIT_FAIL;
 }
 
+static enum piglit_result
+check_sample_count()
+{
+	GLint max_samples;
+
+	if (!sample_count)
+		return PIGLIT_PASS;
+
+	if (sampler.data_type == GL_INT ||
+	    sampler.data_type == GL_UNSIGNED_INT) {
+		glGetIntegerv(GL_MAX_INTEGER_SAMPLES, &max_samples);
+		if (sample_count > max_samples) {
+			printf("Sample count of %d not supported,"
+			       " >MAX_INTEGER_SAMPLES\n",
+			       sample_count);
+			return PIGLIT_SKIP;
+		}
+	} else {
+		glGetIntegerv(GL_MAX_SAMPLES, &max_samples);
+		if (sample_count > max_samples) {
+			printf("Sample count of %d not supported,"
+			       " >MAX_SAMPLES\n",
+			       sample_count);
+			return PIGLIT_SKIP;
+		}
+	}
+
+	return PIGLIT_PASS;
+}
+
+/**
+ * Sweep mode: by default, the samplers all.py tests for this GLSL version.
+ */
+static bool
+sweep_supported()
+{
+	if (!supported_sampler() || is_shadow_sampler())
+		return false;
+	if (has_samples() && (!sample_count || test_offset))
+		return false;
+	return sampler.target != GL_TEXTURE_RECTANGLE || shader_version >= 140;
+}
+
+static enum piglit_result
+sweep_setup()
+{
+	enum piglit_result result;
+
+	if (!supported_sampler()) {
+		printf("%s unsupported\n", sampler.name);
+		return PIGLIT_FAIL;
+	}
+	if (has_samples() && !sample_count) {
+		printf("%s needs a sample count\n", sampler.name);
+		return PIGLIT_FAIL;
+	}
+
+	result = check_sample_count();
+	if (result != PIGLIT_PASS)
+		return result;
+
+	base_size[0] = minx;
+	base_size[1] = has_height() ? miny : 1;
+	base_size[2] = has_slices() ? minz : 1;
+	compute_miplevel_info();
+
+	if (5 + (base_size[0]+1) * base_size[2] >= piglit_width ||
+	    (has_samples() && 5 + (base_size[1]+1) * miplevels >= piglit_height) ||
+	    (!has_samples() && 5 + base_size[1]*2 + miplevels-2 >= piglit_height)) {
+		printf("Size is too big or too many samples.\n");
+		return PIGLIT_FAIL;
+	}
+
+	generate_texture();
+	generate_VBOs();
+	return PIGLIT_PASS;
+}
+
+static enum piglit_result
+sweep_run(enum shader_target stage)
+{
+	bool pass;
+
+	prog = generate_GLSL(stage);
+	if (!prog)
+		return PIGLIT_FAIL;
+
+	divisor_loc = glGetUniformLocation(prog, "divisor");
+	glUseProgram(prog);
+	glUniform1i(glGetUniformLocation(prog, "tex"), 0);
+
+	glViewport(0, 0, piglit_width, piglit_height);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	pass = test_once();
+
+	glUseProgram(0);
+	glDeleteProgram(prog);
+	piglit_present_results();
+
+	return pass ? PIGLIT_PASS : PIGLIT_FAIL;
+}
+
+static void
+sweep_teardown()
+{
+	if (expected_colors)
+		free_expected_colors();
+	glDeleteTextures(1, &tex);
+	glDeleteBuffers(1, &pos_vbo);
+	glDeleteBuffers(1, &tc_vbo);
+	tex = pos_vbo = tc_vbo = 0;
+}
+
+static const struct sampler_sweep texel_fetch_sweep = {
+	"texelFetch",
+	sweep_supported,
+	sweep_setup,
+	sweep_run,
+	sweep_teardown,
+};
+
 void
 piglit_init(int argc, char **argv)
 {
 	int tex_location;
 
+	if (sweep_mode) {
+		if (piglit_get_gl_version() >= 31) {
+			GLuint vao;
+			glGenVertexArrays(1, &vao);
+			glBindVertexArray(vao);
+		}
+
+		glClearColor(0.1, 0.1, 0.1, 1.0);
+		glPointSize(1.0);
+		piglit_report_result(run_sampler_sweep(&texel_fetch_sweep));
+	}
+
 	if (!supported_sampler()) {
 		printf("%s unsupported\n", sampler.name);
 		piglit_report_result(PIGLIT_FAIL);
@@ -957,31 +1131,12 @@ piglit_init(int argc, char **argv)
 
 	require_GL_features(test_stage);
 
-	if (sample_count) {
-		/* check it */
-		GLint max_samples;
-
-		if (sampler.data_type == GL_INT ||
-		    sampler.data_type == GL_UNSIGNED_INT) {
-			glGetIntegerv(GL_MAX_INTEGER_SAMPLES, &max_samples);
-			if (sample_count > max_samples) {
-				printf("Sample count of %d not supported,"
-				       " >MAX_INTEGER_SAMPLES\n",
-				       sample_count);
-				piglit_report_result(PIGLIT_SKIP);
-			}
-		} else {
-			glGetIntegerv(GL_MAX_SAMPLES, &max_samples);
-			if (sample_count > max_samples) {
-				printf("Sample count of %d not supported,"
-				       " >MAX_SAMPLES\n",
-				       sample_count);
-				piglit_report_result(PIGLIT_SKIP);
-			}
-		}
-	}
+	if (check_sample_count() != PIGLIT_PASS)
+		piglit_report_result(PIGLIT_SKIP);
 
 	prog = generate_GLSL(test_stage);
+	if (!prog)
+		piglit_report_result(PIGLIT_FAIL);
 
 	tex_location = glGetUniformLocation(prog, "tex");
 	divisor_loc = glGetUniformLocation(prog, "divisor");
@@ -41,6 +41,11 @@
  * For example:
  * ./bin/textureSamples fs sampler2DMS 4
  * ./bin/textureSamples vs usampler2DMSArray 2
+ *
+ * With "sweep", every multisample sampler is tested in every stage in one
+ * process, see struct sampler_sweep.  The sample count is still required:
+ * ./bin/textureSamples sweep 4
+ * ./bin/textureSamples sweep fs isampler2DMS 8
  */
 #include "common.h"
 
@@ -86,10 +91,42 @@ piglit_display()
 	return pass ? PIGLIT_PASS : PIGLIT_FAIL;
 }
 
-void
+static GLuint tex;
+
+/**
+ * Whether the implementation supports sample_count samples of the current
+ * sampler's data type.
+ */
+static enum piglit_result
+check_sample_count()
+{
+	GLint max_samples;
+
+	if (sampler.data_type == GL_INT ||
+	    sampler.data_type == GL_UNSIGNED_INT) {
+		glGetIntegerv(GL_MAX_INTEGER_SAMPLES, &max_samples);
+		if (sample_count > max_samples) {
+			printf("Sample count of %d not supported,"
+			       " >MAX_INTEGER_SAMPLES\n",
+			       sample_count);
+			return PIGLIT_SKIP;
+		}
+	} else {
+		glGetIntegerv(GL_MAX_SAMPLES, &max_samples);
+		if (sample_count > max_samples) {
+			printf("Sample count of %d not supported,"
+			       " >MAX_SAMPLES\n",
+			       sample_count);
+			return PIGLIT_SKIP;
+		}
+	}
+
+	return PIGLIT_PASS;
+}
+
+enum piglit_result
 generate_texture()
 {
-	GLuint tex;
 	GLint samples = 0;
 	GLenum target = sampler.target;
 
@@ -109,8 +146,10 @@ generate_texture()
 		printf("Sample count of %d not supported, "
 		       "got %d samples\n",
 		       sample_count, samples);
-		piglit_report_result(PIGLIT_SKIP);
+		return PIGLIT_SKIP;
 	}
+
+	return PIGLIT_PASS;
 }
 
 int
@@ -120,9 +159,15 @@ generate_GLSL(enum shader_target test_stage)
 	int prog;
 
 	static char *vs_code;
-	static char *gs_code = NULL;
+	static char *gs_code;
 	static char *fs_code;
 
+	/* Don't let a GS from an earlier call leak into another stage. */
+	free(vs_code);
+	free(gs_code);
+	free(fs_code);
+	vs_code = gs_code = fs_code = NULL;
+
 	switch (test_stage) {
 	case VS:
 		(void)!asprintf(&vs_code,
@@ -228,8 +273,14 @@ generate_GLSL(enum shader_target test_stage)
 		glAttachShader(prog, gs);
 	glAttachShader(prog, fs);
 	glLinkProgram(prog);
-	if (!piglit_link_check_status(prog))
-		piglit_report_result(PIGLIT_FAIL);
+	glDeleteShader(vs);
+	if (gs_code)
+		glDeleteShader(gs);
+	glDeleteShader(fs);
+	if (!piglit_link_check_status(prog)) {
+		glDeleteProgram(prog);
+		return 0;
+	}
 
 	return prog;
 }
@@ -237,7 +288,9 @@ generate_GLSL(enum shader_target test_stage)
 void
 fail_and_show_usage()
 {
-	printf("Usage: textureSamples <vs|gs|fs> <sampler type> <sample_count> [piglit args...]\n");
+	printf("Usage: textureSamples <vs|gs|fs> <sampler type> <sample_count> [piglit args...]\n"
+	       "       textureSamples sweep [vs|gs|fs...] [sampler types...] "
+	       "<sample_count> [piglit args...]\n");
 	piglit_report_result(PIGLIT_SKIP);
 }
 
@@ -249,7 +302,10 @@ parse_args(int argc, char **argv)
 	bool sampler_found = false;
 
 	for (i = 1; i < argc; i++) {
-		if (test_stage == UNKNOWN) {
+		if (parse_sweep_arg(argv[i]))
+			continue;
+
+		if (!sweep_mode && test_stage == UNKNOWN) {
 			/* Maybe it's the shader stage? */
 			if (strcmp(argv[i], "vs") == 0) {
 				test_stage = VS;
@@ -264,11 +320,12 @@ parse_args(int argc, char **argv)
 		}
 
 		/* Maybe it's the sampler type? */
-		if (!sampler_found && (sampler_found = select_sampler(argv[i])))
+		if (!sweep_mode && !sampler_found &&
+		    (sampler_found = select_sampler(argv[i])))
 			continue;
 
 		/* Maybe it's the sample count? */
-		if (sampler_found && !sample_count) {
+		if (!sweep_mode && sampler_found && !sample_count) {
 			sample_count = atoi(argv[i]);
 			continue;
 		}
@@ -276,6 +333,13 @@ parse_args(int argc, char **argv)
 		fail_and_show_usage();
 	}
 
+	/* The sweep tests one sample count, parse_sweep_arg() takes it. */
+	if (sweep_mode) {
+		if (!sample_count)
+			fail_and_show_usage();
+		return;
+	}
+
 	if (test_stage == UNKNOWN || !sampler_found)
 		fail_and_show_usage();
 
@@ -284,36 +348,72 @@ parse_args(int argc, char **argv)
 }
 
 
+/**
+ * Sweep mode: by default, the multisample samplers all.py tests.
+ */
+static bool
+sweep_supported()
+{
+	return has_samples();
+}
+
+static enum piglit_result
+sweep_setup()
+{
+	enum piglit_result result = check_sample_count();
+
+	if (result != PIGLIT_PASS)
+		return result;
+	return generate_texture();
+}
+
+static enum piglit_result
+sweep_run(enum shader_target stage)
+{
+	enum piglit_result result;
+	int prog = generate_GLSL(stage);
+
+	if (!prog)
+		return PIGLIT_FAIL;
+
+	glUseProgram(prog);
+	result = piglit_display();
+
+	glUseProgram(0);
+	glDeleteProgram(prog);
+	return result;
+}
+
+static void
+sweep_teardown()
+{
+	glDeleteTextures(1, &tex);
+	tex = 0;
+}
+
+static const struct sampler_sweep texture_samples_sweep = {
+	"textureSamples",
+	sweep_supported,
+	sweep_setup,
+	sweep_run,
+	sweep_teardown,
+};
+
 void
 piglit_init(int argc, char **argv)
 {
 	int prog;
 
 	piglit_require_extension("GL_ARB_shader_texture_image_samples");
+
+	if (sweep_mode)
+		piglit_report_result(run_sampler_sweep(&texture_samples_sweep));
+
 	require_GL_features(test_stage);
 
 	if (sample_count > 1) {
-		/* check it */
-		GLint max_samples;
-
-		if (sampler.data_type == GL_INT ||
-		    sampler.data_type == GL_UNSIGNED_INT) {
-			glGetIntegerv(GL_MAX_INTEGER_SAMPLES, &max_samples);
-			if (sample_count > max_samples) {
-				printf("Sample count of %d not supported,"
-				       " >MAX_INTEGER_SAMPLES\n",
-				       sample_count);
-				piglit_report_result(PIGLIT_SKIP);
-			}
-		} else {
-			glGetIntegerv(GL_MAX_SAMPLES, &max_samples);
-			if (sample_count > max_samples) {
-				printf("Sample count of %d not supported,"
-				       " >MAX_SAMPLES\n",
-				       sample_count);
-				piglit_report_result(PIGLIT_SKIP);
-			}
-		}
+		if (check_sample_count() != PIGLIT_PASS)
+			piglit_report_result(PIGLIT_SKIP);
 	} else {
 		sample_count = 1;
 	}
@@ -324,5 +424,6 @@ piglit_init(int argc, char **argv)
 
 	glUseProgram(prog);
 
-	generate_texture();
+	if (generate_texture() != PIGLIT_PASS)
+		piglit_report_result(PIGLIT_SKIP);
 }
@@ -43,6 +43,11 @@
  * For example:
  * ./bin/textureSize fs sampler1DArrayShadow
  * ./bin/textureSize vs usamplerCube
+ *
+ * With "sweep", every sampler is tested in every stage in one process,
+ * see struct sampler_sweep:
+ * ./bin/textureSize 140 sweep
+ * ./bin/textureSize sweep vs fs sampler2D isampler2D
  */
 #include "common.h"
 
@@ -74,6 +79,7 @@ static int lod_location;
 static int vertex_location;
 
 static char *extension = "";
+static GLuint tex;
 
 /**
  * Returns the number of components expected from textureSize().
@@ -114,7 +120,7 @@ piglit_display()
 		 1,  1,
 		 1, -1,
 	};
-	GLuint vbo;
+	GLuint vao = 0, vbo;
 
 	glClearColor(0.5, 0.5, 0.5, 1.0);
 	glClear(GL_COLOR_BUFFER_BIT);
@@ -124,7 +130,6 @@ piglit_display()
 	 * vertex buffer object, though.
 	 */
 	if (piglit_get_gl_version() >= 31) {
-		GLuint vao;
 		glGenVertexArrays(1, &vao);
 		glBindVertexArray(vao);
 	}
@@ -160,6 +165,9 @@ piglit_display()
 	}
 
 	glDisableVertexAttribArray(vertex_location);
+	glDeleteBuffers(1, &vbo);
+	if (vao)
+		glDeleteVertexArrays(1, &vao);
 	piglit_present_results();
 
 	return pass ? PIGLIT_PASS : PIGLIT_FAIL;
@@ -189,7 +197,6 @@ void
 generate_texture()
 {
 	int l, i;
-	GLuint tex;
 	const GLenum target = sampler.target;
 
 	glActiveTexture(GL_TEXTURE0);
@@ -252,13 +259,19 @@ generate_GLSL(enum shader_target test_stage)
 	int prog;
 
 	static char *vs_code;
-	static char *gs_code = NULL;
+	static char *gs_code;
 	static char *fs_code;
 	char *lod_arg;
 	static const char *zeroes[3] = { "", "0, ", "0, 0, " };
 
 	const int size = sampler_size();
 
+	/* Don't let a GS from an earlier call leak into another stage. */
+	free(vs_code);
+	free(gs_code);
+	free(fs_code);
+	vs_code = gs_code = fs_code = NULL;
+
 	/* The GLSL 1.40 sampler2DRect/samplerBuffer samplers don't
 	 * take a lod argument. Neither do ARB_texture_multisample's
 	 * sampler2DMS/sampler2DMSArray samplers.
@@ -377,8 +390,14 @@ generate_GLSL(enum shader_target test_stage)
 		glAttachShader(prog, gs);
 	glAttachShader(prog, fs);
 	glLinkProgram(prog);
-	if (!piglit_link_check_status(prog))
-		piglit_report_result(PIGLIT_FAIL);
+	glDeleteShader(vs);
+	if (gs_code)
+		glDeleteShader(gs);
+	glDeleteShader(fs);
+	if (!piglit_link_check_status(prog)) {
+		glDeleteProgram(prog);
+		return 0;
+	}
 
 	return prog;
 }
@@ -386,7 +405,9 @@ generate_GLSL(enum shader_target test_stage)
 void
 fail_and_show_usage()
 {
-	printf("Usage: textureSize [140] <vs|gs|fs> <sampler type> [piglit args...]\n");
+	printf("Usage: textureSize [140] <vs|gs|fs> <sampler type> [piglit args...]\n"
+	       "       textureSize [140] sweep [vs|gs|fs...] [sampler types...] "
+	       "[piglit args...]\n");
 	piglit_report_result(PIGLIT_SKIP);
 }
 
@@ -398,7 +419,15 @@ parse_args(int argc, char **argv)
 	bool sampler_found = false;
 
 	for (i = 1; i < argc; i++) {
-		if (test_stage == UNKNOWN) {
+		if (strcmp(argv[i], "140") == 0) {
+			shader_version = 140;
+			continue;
+		}
+
+		if (parse_sweep_arg(argv[i]))
+			continue;
+
+		if (!sweep_mode && test_stage == UNKNOWN) {
 			/* Maybe it's the shader stage? */
 			if (strcmp(argv[i], "vs") == 0) {
 				test_stage = VS;
@@ -412,18 +441,17 @@ parse_args(int argc, char **argv)
 			}
 		}
 
-		if (strcmp(argv[i], "140") == 0) {
-			shader_version = 140;
-			continue;
-		}
-
 		/* Maybe it's the sampler type? */
-		if (!sampler_found && (sampler_found = select_sampler(argv[i])))
+		if (!sweep_mode && !sampler_found &&
+		    (sampler_found = select_sampler(argv[i])))
 			continue;
 
 		fail_and_show_usage();
 	}
 
+	if (sweep_mode)
+		return;
+
 	if (test_stage == UNKNOWN || !sampler_found)
 		fail_and_show_usage();
 
@@ -432,19 +460,103 @@ parse_args(int argc, char **argv)
 }
 
 
+static void
+set_extension()
+{
+	if (sampler.target == GL_TEXTURE_CUBE_MAP_ARRAY)
+		extension = "#extension GL_ARB_texture_cube_map_array : enable\n";
+	else if (sampler.target == GL_TEXTURE_2D_MULTISAMPLE
+		|| sampler.target == GL_TEXTURE_2D_MULTISAMPLE_ARRAY)
+		extension = "#extension GL_ARB_texture_multisample : enable\n";
+	else
+		extension = "";
+}
+
+/**
+ * Sweep mode: by default, the samplers all.py tests for this GLSL version.
+ */
+static bool
+sweep_supported()
+{
+	switch (sampler.target) {
+	case GL_TEXTURE_CUBE_MAP_ARRAY:
+	case GL_TEXTURE_2D_MULTISAMPLE:
+	case GL_TEXTURE_2D_MULTISAMPLE_ARRAY:
+		return false;
+	case GL_TEXTURE_RECTANGLE:
+	case GL_TEXTURE_BUFFER:
+		return shader_version >= 140;
+	default:
+		return true;
+	}
+}
+
+static enum piglit_result
+sweep_setup()
+{
+	/* The multisample levels are the samples, see
+	 * compute_miplevel_info().
+	 */
+	if (has_samples() && !sample_count) {
+		printf("%s needs a sample count\n", sampler.name);
+		return PIGLIT_FAIL;
+	}
+
+	set_extension();
+	set_base_size();
+	compute_miplevel_info();
+	generate_texture();
+	return PIGLIT_PASS;
+}
+
+static enum piglit_result
+sweep_run(enum shader_target stage)
+{
+	enum piglit_result result;
+	int prog = generate_GLSL(stage);
+
+	if (!prog)
+		return PIGLIT_FAIL;
+
+	lod_location = glGetUniformLocation(prog, "lod");
+	vertex_location = glGetAttribLocation(prog, "vertex");
+	glUseProgram(prog);
+	glUniform1i(glGetUniformLocation(prog, "tex"), 0);
+
+	result = piglit_display();
+
+	glUseProgram(0);
+	glDeleteProgram(prog);
+	return result;
+}
+
+static void
+sweep_teardown()
+{
+	glDeleteTextures(1, &tex);
+	tex = 0;
+}
+
+static const struct sampler_sweep texture_size_sweep = {
+	"textureSize",
+	sweep_supported,
+	sweep_setup,
+	sweep_run,
+	sweep_teardown,
+};
+
 void
 piglit_init(int argc, char **argv)
 {
 	int prog;
 	int tex_location;
 
+	if (sweep_mode)
+		piglit_report_result(run_sampler_sweep(&texture_size_sweep));
+
 	require_GL_features(test_stage);
 
-	if (sampler.target == GL_TEXTURE_CUBE_MAP_ARRAY)
-		extension = "#extension GL_ARB_texture_cube_map_array : enable\n";
-	if (sampler.target == GL_TEXTURE_2D_MULTISAMPLE
-		|| sampler.target == GL_TEXTURE_2D_MULTISAMPLE_ARRAY)
-		extension = "#extension GL_ARB_texture_multisample : enable\n";
+	set_extension();
 
 	prog = generate_GLSL(test_stage);
 	if (!prog)
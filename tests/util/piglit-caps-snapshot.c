@@ -0,0 +1,113 @@
+/*
+ * Copyright © 2026 The Piglit project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file piglit-caps-snapshot.c
+ *
+ * Write the capability snapshot of a "compat" or "core" context, or with
+ * the GLES build of an "es" context, into PIGLIT_CAPS_DIR, see
+ * piglit-caps.h.  If a snapshot for the current driver is already there
+ * this exits without creating a context, unless -force is given.  -force
+ * also forgets which contexts the frameworks recorded as impossible to
+ * create with the driver.
+ *
+ *     PIGLIT_CAPS_DIR=<dir> piglit-caps-snapshot compat|core [-force] -auto
+ *     PIGLIT_CAPS_DIR=<dir> piglit-caps-snapshot_gles2 es [-force] -auto
+ */
+
+#include "piglit-util-gl.h"
+#include "piglit-caps.h"
+
+static const char *profile;
+static bool force;
+
+#if defined(PIGLIT_USE_OPENGL)
+#define PROFILES "compat|core"
+#else
+#define PROFILES "es"
+#endif
+
+static void
+usage(const char *name)
+{
+	printf("usage: PIGLIT_CAPS_DIR=<dir> %s " PROFILES " [-force]\n",
+	       name);
+	piglit_report_result(PIGLIT_FAIL);
+}
+
+PIGLIT_GL_TEST_CONFIG_BEGIN
+
+	force = piglit_strip_arg(&argc, argv, "-force");
+	if (argc < 2)
+		usage(argv[0]);
+	profile = argv[1];
+
+	if (!getenv("PIGLIT_CAPS_DIR"))
+		usage(argv[0]);
+
+	/* Ask for the lowest version, drivers give us the highest one
+	 * they support for the profile.
+	 */
+#if defined(PIGLIT_USE_OPENGL)
+	if (strcmp(profile, "compat") == 0)
+		config.supports_gl_compat_version = 10;
+	else if (strcmp(profile, "core") == 0)
+		config.supports_gl_core_version = 32;
+	else
+		usage(argv[0]);
+#else
+	if (strcmp(profile, "es") == 0)
+		config.supports_gl_es_version = 20;
+	else
+		usage(argv[0]);
+#endif
+
+	if (force)
+		piglit_caps_clear_context_failures();
+	else if (piglit_caps_get(profile)) {
+		printf("%s snapshot is up to date\n", profile);
+		piglit_report_result(PIGLIT_PASS);
+	}
+
+	config.window_visual = PIGLIT_GL_VISUAL_RGBA;
+
+PIGLIT_GL_TEST_CONFIG_END
+
+enum piglit_result
+piglit_display(void)
+{
+	/* Unreached */
+	return PIGLIT_FAIL;
+}
+
+void
+piglit_init(int argc, char **argv)
+{
+	char *path = piglit_caps_path(profile);
+	bool ok = piglit_caps_write(path, profile);
+
+	if (ok)
+		printf("Wrote %s\n", path);
+	free(path);
+	piglit_report_result(ok ? PIGLIT_PASS : PIGLIT_FAIL);
+}
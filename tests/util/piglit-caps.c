@@ -0,0 +1,607 @@
+/*
+ * Copyright © 2026 The Piglit project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file piglit-caps.c
+ *
+ * A snapshot is a text file of "name value" lines:
+ *
+ *     key 5f0c1d2e3a4b6c7d
+ *     profile core
+ *     renderer <GL_RENDERER>
+ *     version <GL_VERSION>
+ *     gl_version 46
+ *     es 0
+ *     glsl_version 460
+ *     glsl_es 0
+ *     extensions GL_ARB_foo GL_ARB_bar ...
+ *     GL_MAX_VERTEX_ATTRIBS 16
+ *     ...
+ *
+ * renderer and version are only there for humans; the key is what ties a
+ * snapshot to a driver.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <dlfcn.h>
+#include <libgen.h>
+#include <sys/stat.h>
+#endif
+
+#include "piglit-caps.h"
+#include "piglit-util-gl.h"
+
+/**
+ * Environment variables that select the driver or change what it reports.
+ *
+ * DISPLAY is deliberately absent: it names a connection, not a driver, and
+ * "piglit run --xvfb-displays" hands every test a different one.  The
+ * framework sets PIGLIT_XVFB along with those displays instead, which keeps
+ * the snapshots of the Xvfb driver apart from those of the real X server.
+ */
+static const char *const key_env_vars[] = {
+	"PIGLIT_PLATFORM",
+	"PIGLIT_XVFB",
+	"WAYLAND_DISPLAY",
+	"LD_LIBRARY_PATH",
+	"LIBGL_ALWAYS_SOFTWARE",
+	"LIBGL_DRIVERS_PATH",
+	"GALLIUM_DRIVER",
+	"MESA_LOADER_DRIVER_OVERRIDE",
+	"MESA_GL_VERSION_OVERRIDE",
+	"MESA_GLSL_VERSION_OVERRIDE",
+	"MESA_GLES_VERSION_OVERRIDE",
+	"MESA_EXTENSION_OVERRIDE",
+	"MESA_EXTENSION_MAX_YEAR",
+	"__GLX_VENDOR_LIBRARY_NAME",
+	"__EGL_VENDOR_LIBRARY_FILENAMES",
+	"DRI_PRIME",
+};
+
+/**
+ * Limits recorded in a snapshot.  Those the context doesn't know are
+ * left out.
+ */
+static const GLenum limits[] = {
+	GL_MAX_TEXTURE_SIZE,
+	GL_MAX_3D_TEXTURE_SIZE,
+	GL_MAX_CUBE_MAP_TEXTURE_SIZE,
+	GL_MAX_ARRAY_TEXTURE_LAYERS,
+	GL_MAX_RENDERBUFFER_SIZE,
+	GL_MAX_SAMPLES,
+	GL_MAX_COLOR_ATTACHMENTS,
+	GL_MAX_DRAW_BUFFERS,
+	GL_MAX_DUAL_SOURCE_DRAW_BUFFERS,
+	GL_MAX_CLIP_DISTANCES,
+	GL_MAX_VIEWPORTS,
+	GL_MAX_VERTEX_ATTRIBS,
+	GL_MAX_VERTEX_ATTRIB_BINDINGS,
+	GL_MAX_VERTEX_UNIFORM_COMPONENTS,
+	GL_MAX_VERTEX_UNIFORM_VECTORS,
+	GL_MAX_VERTEX_UNIFORM_BLOCKS,
+	GL_MAX_VERTEX_OUTPUT_COMPONENTS,
+	GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS,
+	GL_MAX_VERTEX_ATOMIC_COUNTERS,
+	GL_MAX_VERTEX_ATOMIC_COUNTER_BUFFERS,
+	GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS,
+	GL_MAX_VERTEX_IMAGE_UNIFORMS,
+	GL_MAX_TESS_GEN_LEVEL,
+	GL_MAX_PATCH_VERTICES,
+	GL_MAX_TESS_CONTROL_UNIFORM_COMPONENTS,
+	GL_MAX_TESS_CONTROL_INPUT_COMPONENTS,
+	GL_MAX_TESS_CONTROL_OUTPUT_COMPONENTS,
+	GL_MAX_TESS_CONTROL_ATOMIC_COUNTERS,
+	GL_MAX_TESS_CONTROL_SHADER_STORAGE_BLOCKS,
+	GL_MAX_TESS_EVALUATION_UNIFORM_COMPONENTS,
+	GL_MAX_TESS_EVALUATION_INPUT_COMPONENTS,
+	GL_MAX_TESS_EVALUATION_OUTPUT_COMPONENTS,
+	GL_MAX_TESS_EVALUATION_ATOMIC_COUNTERS,
+	GL_MAX_TESS_EVALUATION_SHADER_STORAGE_BLOCKS,
+	GL_MAX_GEOMETRY_UNIFORM_COMPONENTS,
+	GL_MAX_GEOMETRY_INPUT_COMPONENTS,
+	GL_MAX_GEOMETRY_OUTPUT_COMPONENTS,
+	GL_MAX_GEOMETRY_OUTPUT_VERTICES,
+	GL_MAX_GEOMETRY_TOTAL_OUTPUT_COMPONENTS,
+	GL_MAX_GEOMETRY_SHADER_INVOCATIONS,
+	GL_MAX_GEOMETRY_ATOMIC_COUNTERS,
+	GL_MAX_GEOMETRY_SHADER_STORAGE_BLOCKS,
+	GL_MAX_FRAGMENT_UNIFORM_COMPONENTS,
+	GL_MAX_FRAGMENT_UNIFORM_VECTORS,
+	GL_MAX_FRAGMENT_UNIFORM_BLOCKS,
+	GL_MAX_FRAGMENT_INPUT_COMPONENTS,
+	GL_MAX_FRAGMENT_ATOMIC_COUNTERS,
+	GL_MAX_FRAGMENT_ATOMIC_COUNTER_BUFFERS,
+	GL_MAX_FRAGMENT_SHADER_STORAGE_BLOCKS,
+	GL_MAX_FRAGMENT_IMAGE_UNIFORMS,
+	GL_MAX_COMPUTE_UNIFORM_COMPONENTS,
+	GL_MAX_COMPUTE_UNIFORM_BLOCKS,
+	GL_MAX_COMPUTE_SHARED_MEMORY_SIZE,
+	GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS,
+	GL_MAX_COMPUTE_ATOMIC_COUNTERS,
+	GL_MAX_COMPUTE_SHADER_STORAGE_BLOCKS,
+	GL_MAX_COMPUTE_IMAGE_UNIFORMS,
+	GL_MAX_VARYING_COMPONENTS,
+	GL_MAX_VARYING_VECTORS,
+	GL_MAX_TEXTURE_IMAGE_UNITS,
+	GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS,
+	GL_MAX_TEXTURE_UNITS,
+	GL_MAX_TEXTURE_COORDS,
+	GL_MAX_CLIP_PLANES,
+	GL_MAX_UNIFORM_BUFFER_BINDINGS,
+	GL_MAX_UNIFORM_BLOCK_SIZE,
+	GL_MAX_COMBINED_UNIFORM_BLOCKS,
+	GL_MAX_SUBROUTINES,
+	GL_MAX_SUBROUTINE_UNIFORM_LOCATIONS,
+	GL_MAX_TRANSFORM_FEEDBACK_BUFFERS,
+	GL_MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS,
+	GL_MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS,
+	GL_MAX_TRANSFORM_FEEDBACK_SEPARATE_COMPONENTS,
+	GL_MAX_ATOMIC_COUNTER_BUFFER_BINDINGS,
+	GL_MAX_ATOMIC_COUNTER_BUFFER_SIZE,
+	GL_MAX_COMBINED_ATOMIC_COUNTERS,
+	GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS,
+	GL_MAX_SHADER_STORAGE_BLOCK_SIZE,
+	GL_MAX_COMBINED_SHADER_STORAGE_BLOCKS,
+	GL_MAX_IMAGE_UNITS,
+	GL_MAX_COMBINED_IMAGE_UNIFORMS,
+	GL_MAX_UNIFORM_LOCATIONS,
+	GL_MAX_SAMPLE_MASK_WORDS,
+	GL_MAX_COLOR_TEXTURE_SAMPLES,
+	GL_MAX_DEPTH_TEXTURE_SAMPLES,
+	GL_MAX_INTEGER_SAMPLES,
+	GL_MAX_TEXTURE_BUFFER_SIZE,
+	GL_MAX_ELEMENTS_VERTICES,
+	GL_MAX_ELEMENTS_INDICES,
+};
+
+struct caps_limit {
+	char *name;
+	int value;
+};
+
+struct caps_snapshot {
+	struct piglit_caps caps;
+	struct caps_limit *limits;
+	unsigned num_limits;
+};
+
+static uint64_t
+hash_bytes(uint64_t hash, const void *data, size_t size)
+{
+	const unsigned char *p = data;
+	size_t i;
+
+	/* FNV-1a */
+	for (i = 0; i < size; i++) {
+		hash ^= p[i];
+		hash *= UINT64_C(0x100000001b3);
+	}
+	return hash;
+}
+
+static uint64_t
+hash_string(uint64_t hash, const char *s)
+{
+	return hash_bytes(hash, s ? s : "", s ? strlen(s) + 1 : 1);
+}
+
+#if defined(__linux__)
+static uint64_t
+hash_file_identity(uint64_t hash, const char *path)
+{
+	struct stat st;
+
+	memset(&st, 0, sizeof(st));
+	stat(path, &st);
+	hash = hash_string(hash, path);
+	hash = hash_bytes(hash, &st.st_ino, sizeof(st.st_ino));
+	hash = hash_bytes(hash, &st.st_size, sizeof(st.st_size));
+	hash = hash_bytes(hash, &st.st_mtime, sizeof(st.st_mtime));
+	return hash;
+}
+
+/**
+ * Hash the library that provides \p symbol, and the directories a driver
+ * loaded by it is usually found in.  Package updates replace files by
+ * renaming into those directories, which changes their mtime, so this
+ * also catches a driver update behind a dispatch library such as
+ * libglvnd.
+ */
+static uint64_t
+hash_library(uint64_t hash, const char *symbol)
+{
+	void *p = dlsym(RTLD_DEFAULT, symbol);
+	char path[4096], dri[4096 + 4];
+	const char *dir;
+	Dl_info info;
+
+	if (!p || !dladdr(p, &info) || !info.dli_fname)
+		return hash_string(hash, symbol);
+
+	hash = hash_file_identity(hash, info.dli_fname);
+
+	snprintf(path, sizeof(path), "%s", info.dli_fname);
+	dir = dirname(path);
+	hash = hash_file_identity(hash, dir);
+	snprintf(dri, sizeof(dri), "%s/dri", dir);
+	return hash_file_identity(hash, dri);
+}
+#endif
+
+static uint64_t
+caps_key(void)
+{
+	uint64_t hash = UINT64_C(0xcbf29ce484222325);
+	unsigned i;
+
+	for (i = 0; i < ARRAY_SIZE(key_env_vars); i++)
+		hash = hash_string(hash, getenv(key_env_vars[i]));
+
+#if defined(__linux__)
+	hash = hash_library(hash, "glXGetProcAddressARB");
+	hash = hash_library(hash, "eglGetProcAddress");
+	hash = hash_library(hash, "glGetString");
+#endif
+
+	return hash;
+}
+
+char *
+piglit_caps_path(const char *profile)
+{
+	const char *dir = getenv("PIGLIT_CAPS_DIR");
+	char *path;
+
+	if (!dir || !dir[0])
+		return NULL;
+
+	if (asprintf(&path, "%s%c%016" PRIx64 "-%s.caps", dir,
+		     PIGLIT_PATH_SEP, caps_key(), profile) < 0)
+		return NULL;
+	return path;
+}
+
+static struct caps_snapshot *
+load_snapshot(const char *path, const char *profile)
+{
+	struct caps_snapshot *snap;
+	char *text, *line, *next;
+
+	text = piglit_load_text_file(path, NULL);
+	if (!text)
+		return NULL;
+
+	snap = calloc(1, sizeof(*snap));
+	snap->caps.profile = profile;
+	snap->caps.extensions = "";
+
+	for (line = text; line && *line; line = next) {
+		char *value;
+
+		next = strchr(line, '\n');
+		if (next)
+			*next++ = '\0';
+
+		value = strchr(line, ' ');
+		if (!value)
+			continue;
+		*value++ = '\0';
+
+		if (strcmp(line, "gl_version") == 0) {
+			snap->caps.gl_version = atoi(value);
+		} else if (strcmp(line, "es") == 0) {
+			snap->caps.es = atoi(value) != 0;
+		} else if (strcmp(line, "glsl_version") == 0) {
+			snap->caps.glsl_version = atoi(value);
+		} else if (strcmp(line, "glsl_es") == 0) {
+			snap->caps.glsl_es = atoi(value) != 0;
+		} else if (strcmp(line, "extensions") == 0) {
+			snap->caps.extensions = value;
+		} else if (strncmp(line, "GL_", 3) == 0) {
+			snap->limits = realloc(snap->limits,
+					       (snap->num_limits + 1) *
+					       sizeof(*snap->limits));
+			snap->limits[snap->num_limits].name = line;
+			snap->limits[snap->num_limits].value = atoi(value);
+			snap->num_limits++;
+		}
+	}
+
+	/* The strings point into text, which lives as long as the
+	 * snapshot, i.e. until the process exits.
+	 */
+	if (snap->caps.gl_version == 0) {
+		free(snap->limits);
+		free(snap);
+		free(text);
+		return NULL;
+	}
+
+	return snap;
+}
+
+const struct piglit_caps *
+piglit_caps_get(const char *profile)
+{
+	static const char *const profiles[] = { "compat", "core", "es" };
+	static struct caps_snapshot *snapshots[ARRAY_SIZE(profiles)];
+	static bool loaded[ARRAY_SIZE(profiles)];
+	unsigned i;
+
+	for (i = 0; i < ARRAY_SIZE(profiles); i++) {
+		if (strcmp(profile, profiles[i]) == 0)
+			break;
+	}
+	if (i == ARRAY_SIZE(profiles))
+		return NULL;
+
+	if (!loaded[i]) {
+		char *path = piglit_caps_path(profiles[i]);
+
+		if (path)
+			snapshots[i] = load_snapshot(path, profiles[i]);
+		loaded[i] = true;
+		free(path);
+	}
+
+	return snapshots[i] ? &snapshots[i]->caps : NULL;
+}
+
+bool
+piglit_caps_has_extension(const struct piglit_caps *caps, const char *name)
+{
+	return piglit_is_extension_in_string(caps->extensions, name);
+}
+
+bool
+piglit_caps_get_integer(const struct piglit_caps *caps, const char *name,
+			int *value)
+{
+	const struct caps_snapshot *snap = (const struct caps_snapshot *) caps;
+	unsigned i;
+
+	for (i = 0; i < snap->num_limits; i++) {
+		if (strcmp(snap->limits[i].name, name) == 0) {
+			*value = snap->limits[i].value;
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool
+add_candidate(struct piglit_caps_candidate *candidates, int *count,
+	      const char *profile, int min_version)
+{
+	const struct piglit_caps *caps = piglit_caps_get(profile);
+
+	if (!caps)
+		return false;
+
+	if (caps->gl_version >= min_version) {
+		candidates[*count].caps = caps;
+		candidates[*count].min_version = min_version;
+		(*count)++;
+	}
+	return true;
+}
+
+int
+piglit_caps_for_config(const struct piglit_gl_test_config *config,
+		       struct piglit_caps_candidate candidates[2])
+{
+	int count = 0;
+
+	/* Mirror the order in which the frameworks try to create contexts. */
+#if defined(PIGLIT_USE_OPENGL)
+	if (config->supports_gl_core_version &&
+	    !add_candidate(candidates, &count, "core",
+			   config->supports_gl_core_version))
+		return -1;
+	if (config->supports_gl_compat_version &&
+	    !add_candidate(candidates, &count, "compat",
+			   config->supports_gl_compat_version))
+		return -1;
+#else
+	if (!add_candidate(candidates, &count, "es",
+			   config->supports_gl_es_version))
+		return -1;
+#endif
+
+	return count;
+}
+
+static void
+write_extensions(FILE *f)
+{
+	const char *sep = "";
+
+	fputs("extensions ", f);
+	if (piglit_get_gl_version() < 30 || piglit_is_gles()) {
+		fputs((const char *) glGetString(GL_EXTENSIONS), f);
+	} else {
+		int i, num_extensions;
+
+		glGetIntegerv(GL_NUM_EXTENSIONS, &num_extensions);
+		for (i = 0; i < num_extensions; i++) {
+			fprintf(f, "%s%s", sep,
+				(const char *) glGetStringi(GL_EXTENSIONS, i));
+			sep = " ";
+		}
+	}
+	fputc('\n', f);
+}
+
+bool
+piglit_caps_write(const char *path, const char *profile)
+{
+	char *tmp;
+	FILE *f;
+	bool glsl_es = false;
+	int major = 0, minor = 0;
+	unsigned i;
+
+	if (asprintf(&tmp, "%s.%d.tmp", path, (int) getpid()) < 0)
+		return false;
+
+	f = fopen(tmp, "w");
+	if (!f) {
+		fprintf(stderr, "Couldn't open %s for writing\n", tmp);
+		free(tmp);
+		return false;
+	}
+
+	if (piglit_get_gl_version() >= 20 || piglit_is_gles())
+		piglit_get_glsl_version(&glsl_es, &major, &minor);
+
+	fprintf(f, "key %016" PRIx64 "\n", caps_key());
+	fprintf(f, "profile %s\n", profile);
+	fprintf(f, "renderer %s\n", (const char *) glGetString(GL_RENDERER));
+	fprintf(f, "version %s\n", (const char *) glGetString(GL_VERSION));
+	fprintf(f, "gl_version %d\n", piglit_get_gl_version());
+	fprintf(f, "es %d\n", piglit_is_gles());
+	fprintf(f, "glsl_version %d\n", major * 100 + minor);
+	fprintf(f, "glsl_es %d\n", glsl_es);
+	write_extensions(f);
+
+	/* Drain errors left behind by anything else. */
+	while (glGetError() != GL_NO_ERROR)
+		;
+
+	for (i = 0; i < ARRAY_SIZE(limits); i++) {
+		int value = 0;
+
+		glGetIntegerv(limits[i], &value);
+		if (glGetError() != GL_NO_ERROR)
+			continue;
+		fprintf(f, "%s %d\n", piglit_get_gl_enum_name(limits[i]),
+			value);
+	}
+
+	if (fclose(f) != 0 || rename(tmp, path) != 0) {
+		fprintf(stderr, "Couldn't write %s\n", path);
+		unlink(tmp);
+		free(tmp);
+		return false;
+	}
+
+	free(tmp);
+	return true;
+}
+
+/**
+ * Descriptions of the contexts that couldn't be created with the current
+ * driver, one per line.
+ */
+static char *failed_contexts;
+static bool failed_contexts_loaded;
+
+static char *
+contexts_path(void)
+{
+	const char *dir = getenv("PIGLIT_CAPS_DIR");
+	char *path;
+
+	if (!dir || !dir[0])
+		return NULL;
+
+	if (asprintf(&path, "%s%c%016" PRIx64 "-contexts", dir,
+		     PIGLIT_PATH_SEP, caps_key()) < 0)
+		return NULL;
+	return path;
+}
+
+bool
+piglit_caps_context_failed(const char *desc)
+{
+	const size_t len = strlen(desc);
+	const char *line;
+
+	if (!failed_contexts_loaded) {
+		char *path = contexts_path();
+
+		if (path)
+			failed_contexts = piglit_load_text_file(path, NULL);
+		failed_contexts_loaded = true;
+		free(path);
+	}
+
+	line = failed_contexts;
+	while (line && *line) {
+		if (strncmp(line, desc, len) == 0 &&
+		    (line[len] == '\n' || line[len] == '\0'))
+			return true;
+
+		line = strchr(line, '\n');
+		if (line)
+			line++;
+	}
+
+	return false;
+}
+
+void
+piglit_caps_record_context_failure(const char *desc)
+{
+	char *path = contexts_path();
+	FILE *f;
+
+	if (!path)
+		return;
+
+	/* Lines are short enough for concurrent appends not to
+	 * interleave.
+	 */
+	f = fopen(path, "a");
+	if (f) {
+		fprintf(f, "%s\n", desc);
+		fclose(f);
+	}
+	free(path);
+}
+
+void
+piglit_caps_clear_context_failures(void)
+{
+	char *path = contexts_path();
+
+	if (path)
+		unlink(path);
+	free(path);
+
+	free(failed_contexts);
+	failed_contexts = NULL;
+	failed_contexts_loaded = true;
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright © 2026 The Piglit project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file piglit-caps.h
+ *
+ * Driver capability snapshots, for deciding that a test will skip before
+ * paying for context creation.
+ *
+ * A snapshot records what one kind of context ("compat", "core" or "es")
+ * reports: GL and GLSL versions, extensions and GL_MAX_* limits.  It is
+ * written by the piglit-caps-snapshot utility into the directory named by
+ * PIGLIT_CAPS_DIR, in a file whose name includes a key derived from the GL
+ * libraries and the environment variables that select or override the
+ * driver, so a driver update or an override makes the old snapshot
+ * invisible instead of wrong.
+ *
+ * Everything here is advisory: when there is no usable snapshot, or a
+ * requirement isn't covered by it, tests must fall back to checking the
+ * real context.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "piglit-util-gl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct piglit_caps {
+	/** "compat", "core" or "es". */
+	const char *profile;
+
+	/** As piglit_get_gl_version(), 10 * major + minor. */
+	int gl_version;
+	bool es;
+
+	/** 100 * major + minor, and whether it is GLSL ES. */
+	int glsl_version;
+	bool glsl_es;
+
+	/** Space separated, as glGetString(GL_EXTENSIONS). */
+	const char *extensions;
+};
+
+/**
+ * A context the framework may create for a test config, in the order it
+ * tries them, and the snapshot of that kind of context.
+ */
+struct piglit_caps_candidate {
+	const struct piglit_caps *caps;
+
+	/** Context creation fails if caps->gl_version is lower than this. */
+	int min_version;
+};
+
+/**
+ * Return the snapshot for \p profile, or NULL if PIGLIT_CAPS_DIR isn't
+ * set or holds no snapshot for the current driver.
+ */
+const struct piglit_caps *
+piglit_caps_get(const char *profile);
+
+bool
+piglit_caps_has_extension(const struct piglit_caps *caps, const char *name);
+
+/**
+ * Look up the integer limit \p name, e.g. "GL_MAX_VERTEX_ATTRIBS".
+ * Returns false if the snapshot doesn't have it.
+ */
+bool
+piglit_caps_get_integer(const struct piglit_caps *caps, const char *name,
+			int *value);
+
+/**
+ * Fill \p candidates with the contexts the framework may create for
+ * \p config.  Returns the number of candidates, or -1 if any of them has
+ * no snapshot, in which case nothing can be decided without a context.
+ * Candidates whose snapshot is too old a version for context creation to
+ * succeed are left out, so 0 means no context can be created at all.
+ */
+int
+piglit_caps_for_config(const struct piglit_gl_test_config *config,
+		       struct piglit_caps_candidate candidates[2]);
+
+/**
+ * Return the snapshot file name for \p profile, or NULL if PIGLIT_CAPS_DIR
+ * isn't set.  The caller frees it.
+ */
+char *
+piglit_caps_path(const char *profile);
+
+/**
+ * Write a snapshot of the current context to \p path as \p profile.
+ */
+bool
+piglit_caps_write(const char *path, const char *profile);
+
+/**
+ * Whether creating the context described by \p desc failed before with
+ * the current driver.  Frameworks use this to skip context creation
+ * attempts that are bound to fail, \p desc must tell apart everything
+ * they request.  Failures are kept next to the snapshots in
+ * PIGLIT_CAPS_DIR, and like them are keyed on the driver.
+ */
+bool
+piglit_caps_context_failed(const char *desc);
+
+/**
+ * Record that creating the context described by \p desc failed.  Only
+ * failures that would recur with the same driver should be recorded.
+ */
+void
+piglit_caps_record_context_failure(const char *desc);
+
+/**
+ * Forget the context creation failures recorded for the current driver.
+ */
+void
+piglit_caps_clear_context_failures(void);
+
+#ifdef __cplusplus
+} /* end extern "C" */
+#endif
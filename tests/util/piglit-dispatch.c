@@ -128,6 +128,220 @@ check_extension(const char *name)
 
 #include "piglit-dispatch-gen.c"
 
+/**
+ * \name Live GL object accounting
+ *
+ * With PIGLIT_REPORT_RESOURCES set, the functions creating and deleting
+ * textures, buffers, framebuffers and programs are wrapped so that the
+ * number of live names of each can be added to resource reports, see
+ * piglit_report_resources_hook.
+ *
+ * \{
+ */
+struct object_set {
+	/** Open addressing hash table of names, 0 marks a free slot. */
+	GLuint *names;
+	unsigned capacity;
+	unsigned count;
+};
+
+static struct object_set live_textures;
+static struct object_set live_buffers;
+static struct object_set live_framebuffers;
+static struct object_set live_programs;
+
+static unsigned
+object_set_hash(const struct object_set *set, GLuint name)
+{
+	return (name * 2654435761u) & (set->capacity - 1);
+}
+
+static void
+object_set_add(struct object_set *set, GLuint name)
+{
+	unsigned i;
+
+	if (name == 0)
+		return;
+
+	if (2 * (set->count + 1) > set->capacity) {
+		struct object_set grown = {
+			calloc(MAX2(2 * set->capacity, 64), sizeof(GLuint)),
+			MAX2(2 * set->capacity, 64),
+			0
+		};
+
+		for (i = 0; i < set->capacity; i++)
+			if (set->names[i])
+				object_set_add(&grown, set->names[i]);
+		free(set->names);
+		*set = grown;
+	}
+
+	for (i = object_set_hash(set, name); set->names[i];
+	     i = (i + 1) & (set->capacity - 1)) {
+		if (set->names[i] == name)
+			return;
+	}
+	set->names[i] = name;
+	set->count++;
+}
+
+static void
+object_set_remove(struct object_set *set, GLuint name)
+{
+	const unsigned mask = set->capacity - 1;
+	unsigned i, j;
+
+	if (name == 0 || set->count == 0)
+		return;
+
+	for (i = object_set_hash(set, name); set->names[i] != name;
+	     i = (i + 1) & mask) {
+		if (!set->names[i])
+			return;
+	}
+
+	/* Shift later members of the probe sequence back into the hole. */
+	for (j = i;;) {
+		unsigned home;
+
+		set->names[i] = 0;
+		do {
+			j = (j + 1) & mask;
+			if (!set->names[j]) {
+				set->count--;
+				return;
+			}
+			home = object_set_hash(set, set->names[j]);
+		} while (i <= j ? (i < home && home <= j)
+				: (i < home || home <= j));
+		set->names[i] = set->names[j];
+		i = j;
+	}
+}
+
+/*
+ * The first call of a wrapped function may go through the dispatch stub,
+ * which resolves the function and replaces the wrapper with it; put the
+ * wrapper back.
+ *
+ * Functions are named without their "gl" prefix here, since glFoo is
+ * itself a macro expanding to piglit_dispatch_glFoo.
+ */
+#define REWRAP(func)							\
+	if (piglit_dispatch_gl##func != tracked_##func) {		\
+		real_##func = piglit_dispatch_gl##func;			\
+		piglit_dispatch_gl##func = tracked_##func;		\
+	}
+
+#define TRACK_GEN(func, type, set)					\
+	static type real_##func;					\
+	static void APIENTRY						\
+	tracked_##func(GLsizei n, GLuint *names)			\
+	{								\
+		GLsizei i;						\
+		real_##func(n, names);					\
+		REWRAP(func);						\
+		for (i = 0; i < n; i++)					\
+			object_set_add(&set, names[i]);			\
+	}
+
+#define TRACK_CREATE(func, type, set)					\
+	static type real_##func;					\
+	static void APIENTRY						\
+	tracked_##func(GLenum target, GLsizei n, GLuint *names)	\
+	{								\
+		GLsizei i;						\
+		real_##func(target, n, names);				\
+		REWRAP(func);						\
+		for (i = 0; i < n; i++)					\
+			object_set_add(&set, names[i]);			\
+	}
+
+#define TRACK_DELETE(func, type, set)					\
+	static type real_##func;					\
+	static void APIENTRY						\
+	tracked_##func(GLsizei n, const GLuint *names)			\
+	{								\
+		GLsizei i;						\
+		real_##func(n, names);					\
+		REWRAP(func);						\
+		for (i = 0; i < n; i++)					\
+			object_set_remove(&set, names[i]);		\
+	}
+
+TRACK_GEN(GenTextures, PFNGLGENTEXTURESPROC, live_textures)
+TRACK_CREATE(CreateTextures, PFNGLCREATETEXTURESPROC, live_textures)
+TRACK_DELETE(DeleteTextures, PFNGLDELETETEXTURESPROC, live_textures)
+TRACK_GEN(GenBuffers, PFNGLGENBUFFERSPROC, live_buffers)
+TRACK_GEN(CreateBuffers, PFNGLCREATEBUFFERSPROC, live_buffers)
+TRACK_DELETE(DeleteBuffers, PFNGLDELETEBUFFERSPROC, live_buffers)
+TRACK_GEN(GenFramebuffers, PFNGLGENFRAMEBUFFERSPROC, live_framebuffers)
+TRACK_GEN(CreateFramebuffers, PFNGLCREATEFRAMEBUFFERSPROC,
+	  live_framebuffers)
+TRACK_DELETE(DeleteFramebuffers, PFNGLDELETEFRAMEBUFFERSPROC,
+	     live_framebuffers)
+
+static PFNGLCREATEPROGRAMPROC real_CreateProgram;
+static GLuint APIENTRY
+tracked_CreateProgram(void)
+{
+	GLuint prog = real_CreateProgram();
+	REWRAP(CreateProgram);
+	object_set_add(&live_programs, prog);
+	return prog;
+}
+
+static PFNGLCREATESHADERPROGRAMVPROC real_CreateShaderProgramv;
+static GLuint APIENTRY
+tracked_CreateShaderProgramv(GLenum type, GLsizei count,
+			       const GLchar *const *strings)
+{
+	GLuint prog = real_CreateShaderProgramv(type, count, strings);
+	REWRAP(CreateShaderProgramv);
+	object_set_add(&live_programs, prog);
+	return prog;
+}
+
+static PFNGLDELETEPROGRAMPROC real_DeleteProgram;
+static void APIENTRY
+tracked_DeleteProgram(GLuint prog)
+{
+	real_DeleteProgram(prog);
+	REWRAP(DeleteProgram);
+	object_set_remove(&live_programs, prog);
+}
+
+static void
+report_live_objects(void)
+{
+	printf(", \"textures\": %u, \"buffers\": %u, "
+	       "\"framebuffers\": %u, \"programs\": %u",
+	       live_textures.count, live_buffers.count,
+	       live_framebuffers.count, live_programs.count);
+}
+
+static void
+track_live_objects(void)
+{
+	REWRAP(GenTextures);
+	REWRAP(CreateTextures);
+	REWRAP(DeleteTextures);
+	REWRAP(GenBuffers);
+	REWRAP(CreateBuffers);
+	REWRAP(DeleteBuffers);
+	REWRAP(GenFramebuffers);
+	REWRAP(CreateFramebuffers);
+	REWRAP(DeleteFramebuffers);
+	REWRAP(CreateProgram);
+	REWRAP(CreateShaderProgramv);
+	REWRAP(DeleteProgram);
+
+	piglit_report_resources_hook = report_live_objects;
+}
+/** \} */
+
 /**
  * Initialize the dispatch mechanism.
  *
@@ -188,6 +402,9 @@ piglit_dispatch_init(piglit_dispatch_api api,
 	 * check_extension().
 	 */
 	gl_version = piglit_get_gl_version();
+
+	if (getenv("PIGLIT_REPORT_RESOURCES"))
+		track_live_objects();
 }
 
 /**
@@ -217,6 +217,7 @@ piglit_gl_test_run(int argc, char *argv[],
 {
 	piglit_width = config->window_width;
 	piglit_height = config->window_height;
+	piglit_fork_subtests = config->fork_subtests;
 
 	gl_fw = piglit_gl_framework_factory(config);
 	if (gl_fw == NULL) {
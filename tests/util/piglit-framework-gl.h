@@ -209,6 +209,13 @@ struct piglit_gl_test_config {
 	const char **selected_subtests;
 	size_t num_selected_subtests;
 
+	/**
+	 * The subtests don't depend on each other, so
+	 * piglit_run_selected_subtests() may run them in separate processes
+	 * when PIGLIT_SUBTEST_JOBS is set.  See piglit_fork_subtests.
+	 */
+	bool fork_subtests;
+
 	/**
 	 * enum used for markin test as supporting KHR_no_error or not.
 	 */
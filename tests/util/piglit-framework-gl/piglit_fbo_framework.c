@@ -125,6 +125,14 @@ init_gl(struct piglit_wfl_framework *wfl_fw)
 		return false;
 	}
 
+	/* Without a surface the context starts with an empty viewport
+	 * and scissor box.
+	 */
+	if (wfl_fw->windowless) {
+		glViewport(0, 0, piglit_width, piglit_height);
+		glScissor(0, 0, piglit_width, piglit_height);
+	}
+
 	return true;
 #endif
 }
@@ -152,6 +160,12 @@ piglit_fbo_framework_create(const struct piglit_gl_test_config *test_config)
 	wfl_fw = calloc(1, sizeof(*wfl_fw));
 	gl_fw = &wfl_fw->gl_fw;
 
+	/* Nothing is ever drawn to the window, so don't create one where
+	 * the context can be made current without a surface.  GLX can't
+	 * do that portably.
+	 */
+	wfl_fw->windowless = piglit_wfl_framework_platform_is_egl(platform);
+
 	ok = piglit_wfl_framework_init(wfl_fw, test_config, platform, NULL);
 	if (!ok)
 		goto fail;
@@ -25,6 +25,7 @@
 
 #include "piglit-util-gl.h"
 #include "piglit-util-waffle.h"
+#include "piglit-caps.h"
 
 #include "piglit_wfl_framework.h"
 
@@ -46,6 +47,24 @@ piglit_wfl_framework(struct piglit_gl_framework *gl_fw)
 	return (struct piglit_wfl_framework*) gl_fw;
 }
 
+bool
+piglit_wfl_framework_platform_is_egl(int32_t platform)
+{
+	switch (platform) {
+#ifdef PIGLIT_HAS_EGL
+	case WAFFLE_PLATFORM_X11_EGL:
+	case WAFFLE_PLATFORM_WAYLAND:
+	case WAFFLE_PLATFORM_GBM:
+#ifdef PIGLIT_HAS_WAFFLE_SURFACELESS_EGL
+	case WAFFLE_PLATFORM_SURFACELESS_EGL:
+#endif
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
 int32_t
 piglit_wfl_framework_choose_platform(const struct piglit_gl_test_config *test_config)
 {
@@ -111,6 +130,17 @@ piglit_wfl_framework_choose_platform(const struct piglit_gl_test_config *test_co
 #endif
 	}
 
+	else if (streq(env, "surfaceless_egl")) {
+#if defined(PIGLIT_HAS_EGL) && defined(PIGLIT_HAS_WAFFLE_SURFACELESS_EGL)
+		return WAFFLE_PLATFORM_SURFACELESS_EGL;
+#else
+		fprintf(stderr, "environment var PIGLIT_PLATFORM=surfaceless_egl, "
+		        "but piglit was built without EGL support or with "
+		        "waffle < 1.6\n");
+		piglit_report_result(PIGLIT_FAIL);
+#endif
+	}
+
 	else if (strcmp(env, "wgl") == 0) {
 #ifdef PIGLIT_HAS_WGL
 		return WAFFLE_PLATFORM_WGL;
@@ -447,6 +477,44 @@ special_case_gl31(struct piglit_wfl_framework *wfl_fw,
 			partial_config_attrib_list);
 }
 
+/**
+ * Whether the last waffle error is one that the same request would get
+ * again with the same driver, rather than, say, running out of memory or
+ * losing the connection to the display server.
+ */
+static bool
+wfl_error_is_deterministic(void)
+{
+	switch (waffle_error_get_code()) {
+	case WAFFLE_ERROR_UNSUPPORTED_ON_PLATFORM:
+	case WAFFLE_ERROR_BAD_ATTRIBUTE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Describe a context creation attempt for piglit_caps_context_failed():
+ * the human readable description, and a hash of everything that is passed
+ * to waffle.
+ */
+static void
+context_failure_key(const struct piglit_wfl_framework *wfl_fw,
+		    const char *ctx_desc, const int32_t attrib_list[],
+		    char *key, size_t key_size)
+{
+	uint32_t hash = 2166136261u;
+	int i;
+
+	/* FNV-1a over the zero-terminated attribute list. */
+	for (i = 0; attrib_list[i]; i++)
+		hash = (hash ^ (uint32_t) attrib_list[i]) * 16777619u;
+
+	snprintf(key, key_size, "%s platform=0x%x attribs=%08x", ctx_desc,
+		 wfl_fw->platform, hash);
+}
+
 static bool
 make_context_current_singlepass(struct piglit_wfl_framework *wfl_fw,
                                 const struct piglit_gl_test_config *test_config,
@@ -456,6 +524,8 @@ make_context_current_singlepass(struct piglit_wfl_framework *wfl_fw,
 	bool ok;
 	int32_t *attrib_list = NULL;
 	char ctx_desc[1024];
+	char failure_key[1100];
+	bool record_failure = false;
 
 	assert(wfl_fw->config == NULL);
 	assert(wfl_fw->context == NULL);
@@ -464,9 +534,21 @@ make_context_current_singlepass(struct piglit_wfl_framework *wfl_fw,
 	parse_test_config(test_config, flavor, ctx_desc, sizeof(ctx_desc),
 			  partial_config_attrib_list, &attrib_list);
 	assert(attrib_list);
+
+	/* Don't retry what is known to fail with this driver. */
+	context_failure_key(wfl_fw, ctx_desc, attrib_list,
+			    failure_key, sizeof(failure_key));
+	if (piglit_caps_context_failed(failure_key)) {
+		printf("piglit: info: Not trying to create a %s, "
+		       "which failed before with this driver\n", ctx_desc);
+		free(attrib_list);
+		return false;
+	}
+
 	wfl_fw->config = waffle_config_choose(wfl_fw->display, attrib_list);
 	free(attrib_list);
 	if (!wfl_fw->config) {
+		record_failure = wfl_error_is_deterministic();
 		wfl_log_error("waffle_config_choose");
 		fprintf(stderr, "piglit: error: Failed to create "
 			"waffle_config for %s\n", ctx_desc);
@@ -475,19 +557,34 @@ make_context_current_singlepass(struct piglit_wfl_framework *wfl_fw,
 
 	wfl_fw->context = waffle_context_create(wfl_fw->config, NULL);
 	if (!wfl_fw->context) {
+		record_failure = wfl_error_is_deterministic();
 		wfl_log_error("waffle_context_create");
 		fprintf(stderr, "piglit: error: Failed to create "
 			"waffle_context for %s\n", ctx_desc);
 		goto fail;
 	}
 
-	wfl_fw->window = wfl_checked_window_create(wfl_fw->config,
-	                                           test_config->window_width,
-	                                           test_config->window_height);
+	/* Without EGL_KHR_surfaceless_context (GL_OES_surfaceless_context
+	 * for ES) making the context current with no surface fails, in which
+	 * case create the window after all.
+	 */
+	if (wfl_fw->windowless &&
+	    !waffle_make_current(wfl_fw->display, NULL, wfl_fw->context)) {
+		printf("piglit: info: Cannot make the context current "
+		       "without a surface, creating a window\n");
+		wfl_fw->windowless = false;
+	}
 
-	wfl_checked_make_current(wfl_fw->display,
-	                         wfl_fw->window,
-	                         wfl_fw->context);
+	if (!wfl_fw->windowless) {
+		wfl_fw->window = wfl_checked_window_create(
+			wfl_fw->config,
+			test_config->window_width,
+			test_config->window_height);
+
+		wfl_checked_make_current(wfl_fw->display,
+		                         wfl_fw->window,
+		                         wfl_fw->context);
+	}
 
 #ifdef PIGLIT_USE_OPENGL
 	piglit_dispatch_default_init(PIGLIT_DISPATCH_GL);
@@ -500,8 +597,10 @@ make_context_current_singlepass(struct piglit_wfl_framework *wfl_fw,
 #endif
 
 	ok = check_gl_version(test_config, flavor, ctx_desc);
-	if (!ok)
-	   goto fail;
+	if (!ok) {
+		record_failure = true;
+		goto fail;
+	}
 
 	ok = special_case_gl31(wfl_fw, test_config, flavor, ctx_desc,
 			       partial_config_attrib_list);
@@ -512,6 +611,9 @@ make_context_current_singlepass(struct piglit_wfl_framework *wfl_fw,
 	return true;
 
 fail:
+	if (record_failure)
+		piglit_caps_record_context_failure(failure_key);
+
 	waffle_make_current(wfl_fw->display, NULL, NULL);
 	waffle_window_destroy(wfl_fw->window);
 	waffle_context_destroy(wfl_fw->context);
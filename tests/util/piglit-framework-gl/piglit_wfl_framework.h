@@ -39,6 +39,15 @@ struct piglit_wfl_framework {
 	struct waffle_config *config;
 	struct waffle_context *context;
 	struct waffle_window *window;
+
+	/**
+	 * Make the context current without creating a window.  Only for
+	 * platforms where piglit_wfl_framework_platform_is_egl() is true.
+	 * Subclasses set this before calling piglit_wfl_framework_init(),
+	 * which clears it and creates a window when the implementation
+	 * lacks EGL_KHR_surfaceless_context.
+	 */
+	bool windowless;
 };
 
 /**
@@ -65,3 +74,9 @@ piglit_wfl_framework_teardown(struct piglit_wfl_framework *wfl_fw);
  */
 int32_t
 piglit_wfl_framework_choose_platform(const struct piglit_gl_test_config *test_config);
+
+/**
+ * Whether \a platform is one of the EGL based WAFFLE_PLATFORM_*.
+ */
+bool
+piglit_wfl_framework_platform_is_egl(int32_t platform);
@@ -53,7 +53,7 @@ run_test(struct piglit_gl_framework *gl_fw,
          int argc, char *argv[])
 {
 	struct piglit_winsys_framework *winsys_fw = piglit_winsys_framework(gl_fw);
-	bool no_window = false;
+	bool no_window = winsys_fw->automatic_without_window;
 	const char *env_no_window = getenv("PIGLIT_NO_WINDOW");
 
 
@@ -77,6 +77,8 @@ run_test(struct piglit_gl_framework *gl_fw,
 		enum piglit_result result = PIGLIT_PASS;
 		if (gl_fw->test_config->display)
 			result = gl_fw->test_config->display();
+		if (winsys_fw->check_window_size)
+			winsys_fw->check_window_size(winsys_fw);
 
 		piglit_report_result(result);
 	}
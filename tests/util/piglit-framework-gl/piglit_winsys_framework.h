@@ -38,6 +38,23 @@ struct piglit_winsys_framework {
 	 */
 	bool need_redisplay;
 
+	/**
+	 * Set by subclasses whose windows can be rendered to and read back
+	 * without being shown.  In automatic mode, tests that don't set
+	 * piglit_gl_test_config::requires_displayed_window then skip
+	 * show_window() and the event loop, as if PIGLIT_NO_WINDOW=1.
+	 * PIGLIT_NO_WINDOW=0 overrides this.
+	 */
+	bool automatic_without_window;
+
+	/**
+	 * May be set by subclasses.  Called in automatic mode after
+	 * display() when the window isn't shown, to report a spurious
+	 * resize if the window no longer has the test's size.
+	 */
+	void
+	(*check_window_size)(struct piglit_winsys_framework *winsys_fw);
+
 	/**
 	 * Must be implemented by subclasses.
 	 *
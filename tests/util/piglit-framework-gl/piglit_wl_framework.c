@@ -31,6 +31,7 @@
 #include "piglit_wl_framework.h"
 
 #include <wayland-client.h>
+#include <wayland-egl.h>
 #include <waffle_wayland.h>
 #include <xkbcommon/xkbcommon.h>
 #include <sys/mman.h>
@@ -40,6 +41,7 @@ struct piglit_wl_framework {
 
 	struct wl_display *dpy;
 	struct wl_registry *registry;
+	struct wl_egl_window *window;
 
 	struct wl_seat *seat;
 	struct wl_keyboard *keyboard;
@@ -246,12 +248,36 @@ enter_event_loop(struct piglit_winsys_framework *winsys_fw)
 		result = test_config->display();
 
 	/* Do not proceed to event loop in case of piglit_automatic. */
-	if (piglit_automatic)
+	if (piglit_automatic) {
+		check_window_size(winsys_fw);
 		piglit_report_result(result);
+	}
 
 	process_events(wl_fw->dpy);
 }
 
+/**
+ * Only the client resizes a wl_egl_window, but check the buffers the test
+ * presented like the other frameworks check their windows.  Nothing is
+ * attached before the first swap.
+ */
+static void
+check_window_size(struct piglit_winsys_framework *winsys_fw)
+{
+	struct piglit_wl_framework *wl_fw =
+		(struct piglit_wl_framework *) winsys_fw;
+	int width = 0, height = 0;
+
+	wl_egl_window_get_attached_size(wl_fw->window, &width, &height);
+	if ((width || height) &&
+	    (width != piglit_width || height != piglit_height)) {
+		printf("Got spurious window resize in automatic run "
+		       "(%d,%d to %d,%d)\n", piglit_width, piglit_height,
+		       width, height);
+		piglit_report_result(PIGLIT_WARN);
+	}
+}
+
 static void
 show_window(struct piglit_winsys_framework *winsys_fw)
 {
@@ -305,10 +331,13 @@ piglit_wl_framework_create(const struct piglit_gl_test_config *test_config)
 		waffle_window_get_native(winsys_fw->wfl_fw.window);
 
 	wl_fw->dpy = n_window->wayland->display.wl_display;
+	wl_fw->window = n_window->wayland->wl_window;
 	wl_fw->registry = wl_display_get_registry(wl_fw->dpy);
 
 	wl_registry_add_listener(wl_fw->registry, &registry_listener, wl_fw);
 
+	winsys_fw->automatic_without_window = true;
+	winsys_fw->check_window_size = check_window_size;
 	winsys_fw->show_window = show_window;
 	winsys_fw->enter_event_loop = enter_event_loop;
 	gl_fw->destroy = destroy;
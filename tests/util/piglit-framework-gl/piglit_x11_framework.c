@@ -187,8 +187,6 @@ show_window(struct piglit_winsys_framework *winsys_fw)
 	struct piglit_wfl_framework *wfl_fw = &winsys_fw->wfl_fw;
 	XWMHints *wm_hints;
 
-	get_native(x11_fw);
-
 	if (piglit_automatic) {
 		/* Prevent the window from grabbing input. */
 		wm_hints = XAllocWMHints();
@@ -231,6 +229,26 @@ piglit_x11_framework_create(const struct piglit_gl_test_config *test_config,
 	if (!ok)
 		goto fail;
 
+	get_native(x11_fw);
+
+	/* An unmapped window is never resized by the window manager, so in
+	 * automatic mode the size can be checked once here instead of
+	 * waiting for ConfigureNotify.
+	 */
+	if (piglit_automatic) {
+		get_window_size(x11_fw);
+		if (piglit_width != test_config->window_width ||
+		    piglit_height != test_config->window_height) {
+			printf("Got spurious window resize in automatic run "
+			       "(%d,%d to %d,%d)\n",
+			       test_config->window_width,
+			       test_config->window_height,
+			       piglit_width, piglit_height);
+			piglit_report_result(PIGLIT_WARN);
+		}
+	}
+
+	winsys_fw->automatic_without_window = true;
 	winsys_fw->show_window = show_window;
 	winsys_fw->enter_event_loop = enter_event_loop;
 	gl_fw->destroy = destroy;
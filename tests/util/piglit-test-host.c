@@ -0,0 +1,265 @@
+/*
+ * Copyright © 2026 The Piglit project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file piglit-test-host.c
+ *
+ * Resident host for tests built as loadable modules
+ * (-DPIGLIT_BUILD_TEST_MODULES=ON).
+ *
+ * The host is linked against the piglit utility libraries and libGL, and
+ * dlopen()s any extra libraries listed in PIGLIT_TEST_HOST_PRELOAD
+ * (colon-separated, e.g. the DRI driver), so that loading and relocating
+ * them is done once instead of once per test.  The framework passes
+ * PIGLIT_TEST_HOST_PRELOAD through from the user's environment but
+ * doesn't set it.
+ *
+ * The host saves dynamic linking only.  It doesn't open a display or
+ * initialize the driver: a display connection or driver state created
+ * before fork() can't be shared by the children, so each test still
+ * connects and creates its contexts itself.
+ *
+ * The host reads one request per line from stdin, forks a child per
+ * request, and the child dlopen()s the test module and calls its main().
+ * Tests therefore still crash, leak and exit() in their own process.
+ *
+ * A request is a tab-separated line:
+ *
+ *     <stdout file> <stderr file> <cwd> [KEY=VALUE ...] -- <module> <argv0> [args ...]
+ *
+ * An empty cwd leaves the working directory unchanged.  The child's
+ * stdout and stderr are redirected to the given files.  For each request
+ * the host writes "started <pid>" once the child exists and
+ * "exit <status>" when it is gone, where status is the exit code or the
+ * negated signal number, as Python's subprocess reports it.  If the
+ * module can't be loaded the child exits with status 127 after printing
+ * a message starting with "piglit-test-host:" to its stderr, so that the
+ * runner can fall back to exec'ing the test binary.
+ *
+ * The child sets PIGLIT_TEST_ARGV to the test's argv joined by tabs,
+ * because /proc/self/exe and /proc/self/cmdline describe the host rather
+ * than the test.  piglit_run_selected_subtests() needs it to re-exec the
+ * test binary for PIGLIT_SUBTEST_JOBS.
+ */
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define MODULE_LOAD_FAILED 127
+
+static void
+preload_libraries(void)
+{
+	const char *list = getenv("PIGLIT_TEST_HOST_PRELOAD");
+	char *copy, *lib, *saveptr;
+
+	if (!list)
+		return;
+
+	copy = strdup(list);
+	for (lib = strtok_r(copy, ":", &saveptr); lib;
+	     lib = strtok_r(NULL, ":", &saveptr)) {
+		if (!dlopen(lib, RTLD_NOW | RTLD_GLOBAL)) {
+			fprintf(stderr, "piglit-test-host: failed to preload "
+				"%s: %s\n", lib, dlerror());
+		}
+	}
+	free(copy);
+}
+
+/**
+ * Split \p line in place at tabs.  Returns the number of fields.
+ */
+static int
+split_fields(char *line, char ***fields)
+{
+	int count = 1, i;
+	char *p;
+
+	for (p = line; *p; p++) {
+		if (*p == '\t')
+			count++;
+	}
+
+	*fields = calloc(count + 1, sizeof(char *));
+	(*fields)[0] = line;
+	for (i = 1, p = line; *p; p++) {
+		if (*p == '\t') {
+			*p = '\0';
+			(*fields)[i++] = p + 1;
+		}
+	}
+
+	return count;
+}
+
+static bool
+redirect(int fd, const char *path, int flags)
+{
+	int new_fd = open(path, flags, 0644);
+
+	if (new_fd < 0)
+		return false;
+	if (new_fd != fd) {
+		dup2(new_fd, fd);
+		close(new_fd);
+	}
+	return true;
+}
+
+/**
+ * Body of the forked child: set up the environment described by
+ * \p fields, then load the module and run it.  Never returns.
+ */
+static void
+run_child(char **fields, int num_fields)
+{
+	int (*test_main)(int argc, char **argv);
+	void *module;
+	int i;
+
+	/* Become a process group leader, so that the runner can kill
+	 * anything the test spawns on timeout.
+	 */
+	setsid();
+
+	if (!redirect(STDIN_FILENO, "/dev/null", O_RDONLY) ||
+	    !redirect(STDOUT_FILENO, fields[0], O_WRONLY | O_CREAT | O_TRUNC) ||
+	    !redirect(STDERR_FILENO, fields[1], O_WRONLY | O_CREAT | O_TRUNC))
+		_exit(MODULE_LOAD_FAILED);
+
+	if (fields[2][0] && chdir(fields[2]) != 0) {
+		fprintf(stderr, "piglit-test-host: failed to chdir to %s\n",
+			fields[2]);
+		_exit(MODULE_LOAD_FAILED);
+	}
+
+	for (i = 3; i < num_fields && strcmp(fields[i], "--") != 0; i++)
+		putenv(fields[i]);
+
+	/* Skip "--"; what is left is the module and its argv. */
+	i++;
+	if (num_fields - i < 2) {
+		fprintf(stderr, "piglit-test-host: malformed request\n");
+		_exit(MODULE_LOAD_FAILED);
+	}
+
+	/* Fields can't contain tabs, so joining them with tabs is
+	 * reversible.
+	 */
+	{
+		size_t size = 1;
+		char *test_argv;
+		int j;
+
+		for (j = i + 1; j < num_fields; j++)
+			size += strlen(fields[j]) + 1;
+		test_argv = calloc(size, 1);
+		for (j = i + 1; j < num_fields; j++) {
+			if (j > i + 1)
+				strcat(test_argv, "\t");
+			strcat(test_argv, fields[j]);
+		}
+		setenv("PIGLIT_TEST_ARGV", test_argv, 1);
+		free(test_argv);
+	}
+
+	module = dlopen(fields[i], RTLD_NOW | RTLD_LOCAL);
+	if (!module) {
+		fprintf(stderr, "piglit-test-host: %s\n", dlerror());
+		_exit(MODULE_LOAD_FAILED);
+	}
+
+	test_main = (int (*)(int, char **)) dlsym(module, "main");
+	if (!test_main) {
+		fprintf(stderr, "piglit-test-host: %s has no main()\n",
+			fields[i]);
+		_exit(MODULE_LOAD_FAILED);
+	}
+
+	exit(test_main(num_fields - i - 1, &fields[i + 1]));
+}
+
+int
+main(int argc, char **argv)
+{
+	char *line = NULL;
+	size_t line_size = 0;
+	ssize_t len;
+
+	preload_libraries();
+
+	/* Report our own replies unbuffered, the runner waits for them. */
+	setvbuf(stdout, NULL, _IOLBF, 0);
+
+	while ((len = getline(&line, &line_size, stdin)) > 0) {
+		char **fields;
+		int num_fields, status;
+		pid_t pid;
+
+		if (line[len - 1] == '\n')
+			line[--len] = '\0';
+		if (len == 0)
+			continue;
+
+		num_fields = split_fields(line, &fields);
+		if (num_fields < 6) {
+			printf("started -1\nexit %d\n", MODULE_LOAD_FAILED);
+			free(fields);
+			continue;
+		}
+
+		fflush(stderr);
+		pid = fork();
+		if (pid == 0)
+			run_child(fields, num_fields);
+
+		printf("started %d\n", (int) pid);
+		if (pid < 0) {
+			printf("exit %d\n", MODULE_LOAD_FAILED);
+			free(fields);
+			continue;
+		}
+
+		while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+			;
+
+		if (WIFSIGNALED(status))
+			printf("exit %d\n", -WTERMSIG(status));
+		else
+			printf("exit %d\n", WEXITSTATUS(status));
+
+		free(fields);
+	}
+
+	free(line);
+	return 0;
+}
@@ -763,6 +763,247 @@ DepthSunburst::draw(const float (*proj)[4])
 }
 
 
+void
+ManifestProgram::compile_single_pass(GLenum attachment, const char *body)
+{
+	static const char *vert =
+		"#version 130\n"
+		"in vec2 pos;\n"
+		"void main()\n"
+		"{\n"
+		"  gl_Position = vec4(pos, 0.0, 1.0);\n"
+		"}\n";
+
+	static const char *frag_template =
+		"#version 130\n"
+		"%s"
+		"uniform %s tex;\n"
+		"void main()\n"
+		"{\n"
+		"  %s value = texelFetch(tex, ivec2(gl_FragCoord.xy), %s).r;\n"
+		"%s"
+		"}\n";
+
+	bool stencil = attachment == GL_STENCIL_ATTACHMENT;
+	bool es;
+	int major, minor;
+
+	single_pass_attachment = attachment;
+	single_pass_prog[0] = single_pass_prog[1] = 0;
+	copy_fbo = copy_tex = 0;
+	copy_format = GL_NONE;
+	copy_width = copy_height = copy_samples = 0;
+
+	piglit_get_glsl_version(&es, &major, &minor);
+	if (es || major * 100 + minor < 130 ||
+	    (stencil && !piglit_is_extension_supported(
+			   "GL_ARB_stencil_texturing")))
+		return;
+
+	for (int ms = 0; ms < 2; ms++) {
+		if (ms && !(piglit_is_extension_supported(
+				    "GL_ARB_texture_multisample") &&
+			    piglit_is_extension_supported(
+				    "GL_ARB_sample_shading")))
+			break;
+
+		char *frag;
+		if (asprintf(&frag, frag_template,
+			     ms ? "#extension GL_ARB_texture_multisample : require\n"
+				  "#extension GL_ARB_sample_shading : require\n"
+				: "",
+			     ms ? (stencil ? "usampler2DMS" : "sampler2DMS")
+				: (stencil ? "usampler2D" : "sampler2D"),
+			     stencil ? "uint" : "float",
+			     ms ? "gl_SampleID" : "0",
+			     body) < 0)
+			return;
+
+		GLuint vs = piglit_compile_shader_text_nothrow(
+			GL_VERTEX_SHADER, vert);
+		GLuint fs = piglit_compile_shader_text_nothrow(
+			GL_FRAGMENT_SHADER, frag);
+		free(frag);
+		if (!vs || !fs) {
+			glDeleteShader(vs);
+			glDeleteShader(fs);
+			continue;
+		}
+
+		GLuint prog = glCreateProgram();
+		glAttachShader(prog, vs);
+		glAttachShader(prog, fs);
+		glBindAttribLocation(prog, 0, "pos");
+		glLinkProgram(prog);
+		glDeleteShader(vs);
+		glDeleteShader(fs);
+		if (!piglit_link_check_status_quiet(prog)) {
+			glDeleteProgram(prog);
+			continue;
+		}
+
+		glUseProgram(prog);
+		glUniform1i(glGetUniformLocation(prog, "tex"), 0);
+		single_pass_prog[ms] = prog;
+	}
+
+	glGenFramebuffers(1, &copy_fbo);
+}
+
+bool
+ManifestProgram::run_single_pass()
+{
+	GLint draw_fbo, read_fbo, type, rb, prev_rb;
+	GLint internal_format, width, height, samples;
+	bool stencil = single_pass_attachment == GL_STENCIL_ATTACHMENT;
+
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw_fbo);
+	if (draw_fbo == 0 || !copy_fbo)
+		return false;
+
+	glGetFramebufferAttachmentParameteriv(
+		GL_DRAW_FRAMEBUFFER, single_pass_attachment,
+		GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, &type);
+	if (type != GL_RENDERBUFFER)
+		return false;
+	glGetFramebufferAttachmentParameteriv(
+		GL_DRAW_FRAMEBUFFER, single_pass_attachment,
+		GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME, &rb);
+
+	glGetIntegerv(GL_RENDERBUFFER_BINDING, &prev_rb);
+	glBindRenderbuffer(GL_RENDERBUFFER, rb);
+	glGetRenderbufferParameteriv(GL_RENDERBUFFER,
+				     GL_RENDERBUFFER_INTERNAL_FORMAT,
+				     &internal_format);
+	glGetRenderbufferParameteriv(GL_RENDERBUFFER, GL_RENDERBUFFER_WIDTH,
+				     &width);
+	glGetRenderbufferParameteriv(GL_RENDERBUFFER, GL_RENDERBUFFER_HEIGHT,
+				     &height);
+	glGetRenderbufferParameteriv(GL_RENDERBUFFER, GL_RENDERBUFFER_SAMPLES,
+				     &samples);
+	glBindRenderbuffer(GL_RENDERBUFFER, prev_rb);
+
+	GLuint prog = single_pass_prog[samples > 0];
+	if (!prog)
+		return false;
+
+	/* The copy is a blit, which needs matching formats. */
+	GLenum format, data_format, data_type;
+	switch (internal_format) {
+	case GL_DEPTH_STENCIL:
+	case GL_DEPTH24_STENCIL8:
+		format = GL_DEPTH24_STENCIL8;
+		data_format = GL_DEPTH_STENCIL;
+		data_type = GL_UNSIGNED_INT_24_8;
+		break;
+	case GL_DEPTH32F_STENCIL8:
+		format = GL_DEPTH32F_STENCIL8;
+		data_format = GL_DEPTH_STENCIL;
+		data_type = GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+		break;
+	case GL_DEPTH_COMPONENT16:
+	case GL_DEPTH_COMPONENT24:
+	case GL_DEPTH_COMPONENT32:
+	case GL_DEPTH_COMPONENT32F:
+		if (stencil)
+			return false;
+		format = internal_format;
+		data_format = GL_DEPTH_COMPONENT;
+		data_type = GL_FLOAT;
+		break;
+	default:
+		return false;
+	}
+
+	/* Check up front what would make the copy fail, rather than
+	 * calling glGetError(), which would swallow errors the test
+	 * hasn't checked for yet.
+	 */
+	GLint max_size, max_samples = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+	if (samples)
+		glGetIntegerv(GL_MAX_DEPTH_TEXTURE_SAMPLES, &max_samples);
+	if (width > max_size || height > max_size || samples > max_samples)
+		return false;
+
+	GLenum target = samples ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+	GLenum target_binding = samples ? GL_TEXTURE_BINDING_2D_MULTISAMPLE
+					: GL_TEXTURE_BINDING_2D;
+	GLint active_texture, tex;
+	glGetIntegerv(GL_ACTIVE_TEXTURE, &active_texture);
+	glActiveTexture(GL_TEXTURE0);
+	glGetIntegerv(target_binding, &tex);
+
+	if (format != copy_format || width != copy_width ||
+	    height != copy_height || samples != copy_samples) {
+		GLint tex_samples = 0;
+
+		glDeleteTextures(1, &copy_tex);
+		glGenTextures(1, &copy_tex);
+		glBindTexture(target, copy_tex);
+		if (samples) {
+			glTexImage2DMultisample(target, samples, format,
+						width, height, GL_TRUE);
+			glGetTexLevelParameteriv(target, 0,
+						 GL_TEXTURE_SAMPLES,
+						 &tex_samples);
+		} else {
+			glTexImage2D(target, 0, format, width, height, 0,
+				     data_format, data_type, NULL);
+			glTexParameteri(target, GL_TEXTURE_MIN_FILTER,
+					GL_NEAREST);
+			glTexParameteri(target, GL_TEXTURE_MAG_FILTER,
+					GL_NEAREST);
+		}
+		if (stencil)
+			glTexParameteri(target, GL_DEPTH_STENCIL_TEXTURE_MODE,
+					GL_STENCIL_INDEX);
+		glBindTexture(target, tex);
+
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, copy_fbo);
+		glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER,
+				       data_format == GL_DEPTH_STENCIL ?
+				       GL_DEPTH_STENCIL_ATTACHMENT :
+				       GL_DEPTH_ATTACHMENT,
+				       target, copy_tex, 0);
+		glDrawBuffer(GL_NONE);
+		bool complete = glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER)
+			== GL_FRAMEBUFFER_COMPLETE;
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw_fbo);
+
+		/* A multisample blit needs matching sample counts. */
+		if (!complete || tex_samples != samples) {
+			glDeleteTextures(1, &copy_tex);
+			copy_tex = 0;
+			copy_format = GL_NONE;
+			glActiveTexture(active_texture);
+			return false;
+		}
+
+		copy_format = format;
+		copy_width = width;
+		copy_height = height;
+		copy_samples = samples;
+	}
+
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &read_fbo);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, draw_fbo);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, copy_fbo);
+	glBlitFramebuffer(0, 0, width, height, 0, 0, width, height,
+			  stencil ? GL_STENCIL_BUFFER_BIT : GL_DEPTH_BUFFER_BIT,
+			  GL_NEAREST);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, read_fbo);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw_fbo);
+
+	glUseProgram(prog);
+	glBindTexture(target, copy_tex);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	glBindTexture(target, tex);
+	glActiveTexture(active_texture);
+
+	return true;
+}
+
 void
 ManifestStencil::compile()
 {
@@ -816,6 +1057,15 @@ ManifestStencil::compile()
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(vertex_data[0]),
 			      (void *) 0);
+
+	/* Stencil value i is the color with bits 2, 1 and 0 of i in red,
+	 * green and blue.
+	 */
+	compile_single_pass(GL_STENCIL_ATTACHMENT,
+			    "  if (value > 7u)\n"
+			    "    discard;\n"
+			    "  gl_FragColor = vec4(uvec3(value) >> uvec3(2, 1, 0)\n"
+			    "                      & uvec3(1), 1.0);\n");
 }
 
 void
@@ -832,17 +1082,20 @@ ManifestStencil::run()
 		{ 1.0, 1.0, 1.0, 1.0 }
 	};
 
-	glUseProgram(prog);
 	glBindVertexArray(vao);
 
-	glEnable(GL_STENCIL_TEST);
-	glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
-
 	/* Clear the color buffer to 0, in case the stencil buffer
 	 * contains any values outside the range 0..7
 	 */
 	glClear(GL_COLOR_BUFFER_BIT);
 
+	if (run_single_pass())
+		return;
+
+	glUseProgram(prog);
+	glEnable(GL_STENCIL_TEST);
+	glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+
 	for (int i = 0; i < 8; ++i) {
 		glStencilFunc(GL_EQUAL, i, 0xff);
 		glUniform4fv(color_loc, 1, colors[i]);
@@ -907,6 +1160,19 @@ ManifestDepth::compile()
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(vertex_data[0]),
 			      (void *) 0);
+
+	/* Pass i of run() draws at window depth (15 - 2i) / 16, and a
+	 * sample takes the color of the first pass that is in front of it.
+	 */
+	compile_single_pass(GL_DEPTH_ATTACHMENT,
+			    "  for (uint i = 0u; i < 8u; i++) {\n"
+			    "    if ((15.0 - 2.0 * float(i)) / 16.0 < value) {\n"
+			    "      gl_FragColor = vec4(uvec3(i) >> uvec3(2, 1, 0)\n"
+			    "                          & uvec3(1), 1.0);\n"
+			    "      return;\n"
+			    "    }\n"
+			    "  }\n"
+			    "  discard;\n");
 }
 
 void
@@ -923,9 +1189,12 @@ ManifestDepth::run()
 		{ 1.0, 1.0, 1.0, 1.0 }
 	};
 
-	glUseProgram(prog);
 	glBindVertexArray(vao);
 
+	if (run_single_pass())
+		return;
+
+	glUseProgram(prog);
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_LESS);
 	glEnable(GL_STENCIL_TEST);
@@ -42,6 +42,39 @@ namespace piglit_util_test_pattern
 	public:
 		virtual void compile() = 0;
 		virtual void run() = 0;
+
+	protected:
+		/**
+		 * Where the driver can sample depth or stencil values, the
+		 * buffer is instead copied into a texture and manifested by
+		 * a single full-screen draw that fetches each sample and
+		 * computes the color the multipass draws would have left.
+		 * \p attachment is GL_DEPTH_ATTACHMENT or
+		 * GL_STENCIL_ATTACHMENT, \p body sets gl_FragColor or
+		 * discards based on "value", the sample's depth (float) or
+		 * stencil (uint) value.
+		 */
+		void compile_single_pass(GLenum attachment, const char *body);
+
+		/**
+		 * Manifest the current draw framebuffer in a single pass.
+		 * Returns false, having drawn nothing, if it can't be done
+		 * for this framebuffer.  The texture, renderbuffer and
+		 * framebuffer bindings are left as they were, and the GL
+		 * error state is not touched.
+		 */
+		bool run_single_pass();
+
+	private:
+		GLenum single_pass_attachment;
+
+		/** Single and multisample versions, 0 if unsupported. */
+		GLuint single_pass_prog[2];
+
+		GLuint copy_fbo;
+		GLuint copy_tex;
+		GLenum copy_format;
+		GLint copy_width, copy_height, copy_samples;
 	};
 
 	/**
@@ -51,6 +84,9 @@ namespace piglit_util_test_pattern
 	 * using the stencil function "EQUAL", and a different color each
 	 * time.  This causes stencil values from 0 to 7 to manifest as colors
 	 * (black, blue, green, cyan, red, magenta, yellow, white).
+	 *
+	 * With ARB_stencil_texturing the colors are computed in one pass,
+	 * see ManifestProgram::compile_single_pass().
 	 */
 	class ManifestStencil : public ManifestProgram
 	{
@@ -75,6 +111,10 @@ namespace piglit_util_test_pattern
 	 * be incremented and it will fail the stencil test on later draws.
 	 * As a result, depth values from back to front will manifest as
 	 * colors (black, blue, green, cyan, red, magenta, yellow, white).
+	 *
+	 * Where depth textures can be sampled the colors are computed in one
+	 * pass, see ManifestProgram::compile_single_pass().  That path leaves
+	 * the depth and stencil buffers untouched.
 	 */
 	class ManifestDepth : public ManifestProgram
 	{
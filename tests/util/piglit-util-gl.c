@@ -385,6 +385,57 @@ piglit_half_from_float(float val)
 	return result;
 }
 
+/**
+ * glReadPixels() for the probes.  With PIGLIT_READBACK_HASH set, this also
+ * adds what was read to the readback hash, see
+ * piglit_readback_hash_update().
+ */
+static void
+read_pixels(GLint x, GLint y, GLsizei w, GLsizei h, GLenum format,
+	    GLenum type, void *pixels)
+{
+	GLint alignment, pack_buffer = 0;
+	size_t bpp, row_size, stride;
+	GLsizei j;
+
+	glReadPixels(x, y, w, h, format, type, pixels);
+
+	if (!piglit_readback_hash_enabled())
+		return;
+
+	/* The data went to a buffer object, there is nothing to hash. */
+	if (piglit_get_gl_version() >= (piglit_is_gles() ? 30 : 21) ||
+	    piglit_is_extension_supported("GL_ARB_pixel_buffer_object"))
+		glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &pack_buffer);
+	if (pack_buffer)
+		return;
+
+	switch (format) {
+	case GL_STENCIL_INDEX:
+		bpp = 1;
+		break;
+	case GL_RGBA_INTEGER:
+		bpp = 4;
+		break;
+	default:
+		bpp = piglit_num_components(format);
+		break;
+	}
+
+	if (type == GL_UNSIGNED_INT_24_8)
+		bpp = 4;
+	else if (type != GL_UNSIGNED_BYTE)
+		bpp *= 4;
+
+	/* Skip the row padding, which glReadPixels doesn't write. */
+	glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+	row_size = w * bpp;
+	stride = ALIGN(row_size, alignment);
+	for (j = 0; j < h; j++)
+		piglit_readback_hash_update((char *) pixels + j * stride,
+					    row_size);
+}
+
 int
 piglit_probe_rect_halves_equal_rgba(int x, int y, int w, int h)
 {
@@ -393,7 +444,7 @@ piglit_probe_rect_halves_equal_rgba(int x, int y, int w, int h)
 	GLfloat probe2[4];
 	GLubyte *pixels = malloc(w*h*4*sizeof(GLubyte));
 
-	glReadPixels(x, y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+	read_pixels(x, y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
 
 	for (j = 0; j < h; j++) {
 		for (i = 0; i < w / 2; i++) {
@@ -1049,7 +1100,7 @@ piglit_get_luminance_intensity_bits(GLenum internalformat, int *bits)
 	return false;
 }
 
-/* Wrapper around glReadPixels that always returns floats; reads and converts
+/* Wrapper around read_pixels that always returns floats; reads and converts
  * GL_UNSIGNED_BYTE on GLES.  If pixels == NULL, malloc a float array of the
  * appropriate size, otherwise use the one provided. */
 static GLfloat *
@@ -1064,12 +1115,12 @@ piglit_read_pixels_float(GLint x, GLint y, GLsizei width, GLsizei height,
 		pixels = malloc(ncomponents * sizeof(GLfloat));
 
 	if (!piglit_is_gles()) {
-		glReadPixels(x, y, width, height, format, GL_FLOAT, pixels);
+		read_pixels(x, y, width, height, format, GL_FLOAT, pixels);
 		return pixels;
 	}
 
 	pixels_b = malloc(ncomponents * sizeof(GLubyte));
-	glReadPixels(x, y, width, height, format, GL_UNSIGNED_BYTE, pixels_b);
+	read_pixels(x, y, width, height, format, GL_UNSIGNED_BYTE, pixels_b);
 	for (i = 0; i < ncomponents; i++)
 		pixels[i] = pixels_b[i] / 255.0;
 	free(pixels_b);
@@ -1237,7 +1288,7 @@ piglit_probe_rect_ubyte(int x, int y, int w, int h, int num_components,
 
 	/* RGBA readbacks are likely to be faster */
 	pixels = malloc(w*h*4);
-	glReadPixels(x, y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+	read_pixels(x, y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
 
 	for (j = 0; j < h; j++) {
 		for (i = 0; i < w; i++) {
@@ -1312,7 +1363,7 @@ piglit_probe_rect_r_ubyte(int x, int y, int w, int h, GLubyte expected)
 	w_aligned = ALIGN(w, 4);
 	pixels = malloc(w_aligned * h);
 
-	glReadPixels(x, y, w, h, GL_RED, GL_UNSIGNED_BYTE, pixels);
+	read_pixels(x, y, w, h, GL_RED, GL_UNSIGNED_BYTE, pixels);
 
 	for (j = 0; j < h; j++) {
 		for (i = 0; i < w; i++) {
@@ -1445,7 +1496,7 @@ piglit_probe_rect_rgba_int(int x, int y, int w, int h, const int *expected)
 	GLint *probe;
 	GLint *pixels = malloc(w*h*4*sizeof(int));
 
-	glReadPixels(x, y, w, h, GL_RGBA_INTEGER, GL_INT, pixels);
+	read_pixels(x, y, w, h, GL_RGBA_INTEGER, GL_INT, pixels);
 
 	for (j = 0; j < h; j++) {
 		for (i = 0; i < w; i++) {
@@ -1478,7 +1529,7 @@ piglit_probe_rect_rgba_uint(int x, int y, int w, int h,
 	GLuint *probe;
 	GLuint *pixels = malloc(w*h*4*sizeof(unsigned int));
 
-	glReadPixels(x, y, w, h, GL_RGBA_INTEGER, GL_UNSIGNED_INT, pixels);
+	read_pixels(x, y, w, h, GL_RGBA_INTEGER, GL_UNSIGNED_INT, pixels);
 
 	for (j = 0; j < h; j++) {
 		for (i = 0; i < w; i++) {
@@ -1773,7 +1824,7 @@ piglit_probe_image_stencil(int x, int y, int w, int h,
 	glGetIntegerv(GL_PACK_ALIGNMENT, &old_pack_alignment);
 	glPixelStorei(GL_PACK_ALIGNMENT, 1);
 
-	glReadPixels(x, y, w, h, GL_STENCIL_INDEX, GL_UNSIGNED_BYTE, pixels);
+	read_pixels(x, y, w, h, GL_STENCIL_INDEX, GL_UNSIGNED_BYTE, pixels);
 
 	glPixelStorei(GL_PACK_ALIGNMENT, old_pack_alignment);
 
@@ -1791,7 +1842,7 @@ piglit_probe_image_ubyte(int x, int y, int w, int h, GLenum format,
 	GLubyte *pixels = malloc(w * h * 4 * sizeof(GLubyte));
 	int i, j, p;
 
-	glReadPixels(x, y, w, h, format, GL_UNSIGNED_BYTE, pixels);
+	read_pixels(x, y, w, h, format, GL_UNSIGNED_BYTE, pixels);
 
 	for (j = 0; j < h; j++) {
 		for (i = 0; i < w; i++) {
@@ -2016,7 +2067,7 @@ int piglit_probe_pixel_depth(int x, int y, float expected)
 	GLfloat probe;
 	GLfloat delta;
 
-	glReadPixels(x, y, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &probe);
+	read_pixels(x, y, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &probe);
 
 	delta = probe - expected;
 	if (fabs(delta) < 0.01)
@@ -2035,7 +2086,7 @@ int piglit_probe_rect_depth(int x, int y, int w, int h, float expected)
 	GLfloat *probe;
 	GLfloat *pixels = malloc(w*h*sizeof(float));
 
-	glReadPixels(x, y, w, h, GL_DEPTH_COMPONENT, GL_FLOAT, pixels);
+	read_pixels(x, y, w, h, GL_DEPTH_COMPONENT, GL_FLOAT, pixels);
 
 	for (j = 0; j < h; j++) {
 		for (i = 0; i < w; i++) {
@@ -2059,7 +2110,7 @@ int piglit_probe_rect_depth(int x, int y, int w, int h, float expected)
 int piglit_probe_pixel_stencil(int x, int y, unsigned expected)
 {
 	GLuint probe;
-	glReadPixels(x, y, 1, 1, GL_STENCIL_INDEX, GL_UNSIGNED_INT, &probe);
+	read_pixels(x, y, 1, 1, GL_STENCIL_INDEX, GL_UNSIGNED_INT, &probe);
 
 	if (probe == expected)
 		return 1;
@@ -2076,7 +2127,7 @@ int piglit_probe_rect_stencil(int x, int y, int w, int h, unsigned expected)
 	int i, j;
 	GLuint *pixels = malloc(w*h*sizeof(GLuint));
 
-	glReadPixels(x, y, w, h, GL_STENCIL_INDEX, GL_UNSIGNED_INT, pixels);
+	read_pixels(x, y, w, h, GL_STENCIL_INDEX, GL_UNSIGNED_INT, pixels);
 
 	for (j = 0; j < h; j++) {
 		for (i = 0; i < w; i++) {
@@ -2095,6 +2146,70 @@ int piglit_probe_rect_stencil(int x, int y, int w, int h, unsigned expected)
 	return 1;
 }
 
+/**
+ * Probe the depth and stencil values of a rectangle with a single packed
+ * GL_DEPTH_STENCIL readback, instead of the two readbacks and the float
+ * conversion of piglit_probe_rect_depth() plus piglit_probe_rect_stencil().
+ * Depth is compared in 24-bit integer space with the same 0.01 tolerance.
+ *
+ * The read framebuffer must have both a depth and a stencil buffer.  Where
+ * packed depth/stencil reads aren't supported this falls back to the two
+ * separate probes.
+ */
+int piglit_probe_rect_depth_stencil(int x, int y, int w, int h,
+				    float expected_depth,
+				    unsigned expected_stencil)
+{
+	const GLuint depth_max = 0xffffff;
+	const GLuint tolerance = 0.01 * depth_max;
+	GLuint expected_z, expected;
+	GLuint *pixels;
+	int i;
+
+	if (piglit_get_gl_version() < 30 &&
+	    !piglit_is_extension_supported("GL_EXT_packed_depth_stencil") &&
+	    !piglit_is_extension_supported("GL_ARB_framebuffer_object")) {
+		int pass = piglit_probe_rect_depth(x, y, w, h, expected_depth);
+		return piglit_probe_rect_stencil(x, y, w, h,
+						 expected_stencil) && pass;
+	}
+
+	expected_depth = CLAMP(expected_depth, 0.0f, 1.0f);
+	expected_z = (GLuint) (expected_depth * depth_max + 0.5f);
+	expected = expected_z << 8 | (expected_stencil & 0xff);
+
+	pixels = malloc(w * h * sizeof(GLuint));
+	read_pixels(x, y, w, h, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8,
+		    pixels);
+
+	for (i = 0; i < w * h; i++) {
+		const GLuint probe = pixels[i];
+		const GLuint z = probe >> 8;
+		const GLuint stencil = probe & 0xff;
+
+		/* Cleared and uniformly drawn buffers match exactly. */
+		if (probe == expected)
+			continue;
+
+		if (stencil == expected_stencil &&
+		    (z > expected_z ? z - expected_z : expected_z - z) <
+		    tolerance)
+			continue;
+
+		printf("Probe depth/stencil at (%i, %i)\n",
+		       x + i % w, y + i / w);
+		printf("  Expected: %f, %u\n", expected_depth,
+		       expected_stencil);
+		printf("  Observed: %f, %u\n", (float) z / depth_max,
+		       stencil);
+		free(pixels);
+		return 0;
+	}
+
+	free(pixels);
+	return 1;
+}
+
 bool piglit_probe_buffer(GLuint buf, GLenum target, const char *label,
 		         unsigned n, unsigned num_components,
 			 const float *expected)
@@ -208,6 +208,9 @@ int piglit_probe_pixel_depth(int x, int y, float expected);
 int piglit_probe_rect_depth(int x, int y, int w, int h, float expected);
 int piglit_probe_pixel_stencil(int x, int y, unsigned expected);
 int piglit_probe_rect_stencil(int x, int y, int w, int h, unsigned expected);
+int piglit_probe_rect_depth_stencil(int x, int y, int w, int h,
+				    float expected_depth,
+				    unsigned expected_stencil);
 int piglit_probe_rect_halves_equal_rgba(int x, int y, int w, int h);
 
 /**
@@ -31,6 +31,9 @@
 #ifdef __linux__
 #include <sys/types.h>
 #include <sys/syscall.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 #include <assert.h>
@@ -59,6 +62,7 @@
 # include <sys/stat.h>
 # include <fcntl.h>
 # include <unistd.h>
+# include <sys/mman.h>
 #else
 # define USE_STDIO
 #endif
@@ -218,6 +222,215 @@ piglit_result_to_string(enum piglit_result result)
         return "Unknown result";
 }
 
+void (*piglit_report_resources_hook)(void);
+
+/**
+ * Print the members of a PIGLIT_REPORT_RESOURCES result line after the
+ * optional subtest name: the process' peak RSS, plus whatever
+ * piglit_report_resources_hook adds.
+ */
+static void
+report_resources(void)
+{
+#ifdef USE_SETRLIMIT
+	struct rusage usage;
+
+	/* ru_maxrss is in kilobytes, except on macOS. */
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+		usage.ru_maxrss /= 1024;
+#endif
+		printf("\"maxrss_kb\": %ld", (long) usage.ru_maxrss);
+	} else {
+		printf("\"maxrss_kb\": null");
+	}
+#else
+	printf("\"maxrss_kb\": null");
+#endif
+
+	if (piglit_report_resources_hook)
+		piglit_report_resources_hook();
+
+	printf("}}\n");
+}
+
+/*
+ * XXH64, from the xxHash reference description.  Its four independent
+ * accumulators let the compiler keep them in flight together.  Input is
+ * read in host byte order, so hashes only compare between runs on
+ * machines of the same endianness.
+ */
+#define XXH_PRIME64_1 0x9E3779B185EBCA87ull
+#define XXH_PRIME64_2 0xC2B2AE3D27D4EB4Full
+#define XXH_PRIME64_3 0x165667B19E3779F9ull
+#define XXH_PRIME64_4 0x85EBCA77C2B2AE63ull
+#define XXH_PRIME64_5 0x27D4EB2F165667C5ull
+
+static inline uint64_t
+xxh_rotl64(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t
+xxh_read64(const unsigned char *p)
+{
+	uint64_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint32_t
+xxh_read32(const unsigned char *p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint64_t
+xxh64_round(uint64_t acc, uint64_t input)
+{
+	acc += input * XXH_PRIME64_2;
+	acc = xxh_rotl64(acc, 31);
+	return acc * XXH_PRIME64_1;
+}
+
+static inline uint64_t
+xxh64_merge(uint64_t acc, uint64_t val)
+{
+	acc ^= xxh64_round(0, val);
+	return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+static uint64_t
+xxh64(const void *data, size_t size, uint64_t seed)
+{
+	const unsigned char *p = data;
+	const unsigned char *const end = p + size;
+	uint64_t h;
+
+	if (size >= 32) {
+		uint64_t v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+		uint64_t v2 = seed + XXH_PRIME64_2;
+		uint64_t v3 = seed;
+		uint64_t v4 = seed - XXH_PRIME64_1;
+
+		do {
+			v1 = xxh64_round(v1, xxh_read64(p));
+			v2 = xxh64_round(v2, xxh_read64(p + 8));
+			v3 = xxh64_round(v3, xxh_read64(p + 16));
+			v4 = xxh64_round(v4, xxh_read64(p + 24));
+			p += 32;
+		} while (end - p >= 32);
+
+		h = xxh_rotl64(v1, 1) + xxh_rotl64(v2, 7) +
+		    xxh_rotl64(v3, 12) + xxh_rotl64(v4, 18);
+		h = xxh64_merge(h, v1);
+		h = xxh64_merge(h, v2);
+		h = xxh64_merge(h, v3);
+		h = xxh64_merge(h, v4);
+	} else {
+		h = seed + XXH_PRIME64_5;
+	}
+
+	h += size;
+
+	for (; end - p >= 8; p += 8) {
+		h ^= xxh64_round(0, xxh_read64(p));
+		h = xxh_rotl64(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+	}
+	if (end - p >= 4) {
+		h ^= xxh_read32(p) * XXH_PRIME64_1;
+		h = xxh_rotl64(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+		p += 4;
+	}
+	for (; p < end; p++) {
+		h ^= *p * XXH_PRIME64_5;
+		h = xxh_rotl64(h, 11) * XXH_PRIME64_1;
+	}
+
+	h ^= h >> 33;
+	h *= XXH_PRIME64_2;
+	h ^= h >> 29;
+	h *= XXH_PRIME64_3;
+	h ^= h >> 32;
+	return h;
+}
+
+/** Hash of everything read back since the last reported result. */
+static uint64_t readback_hash;
+static bool readback_hashed;
+
+bool
+piglit_readback_hash_enabled(void)
+{
+	static int enabled = -1;
+
+	if (enabled < 0)
+		enabled = getenv("PIGLIT_READBACK_HASH") != NULL;
+	return enabled;
+}
+
+void
+piglit_readback_hash_update(const void *data, size_t size)
+{
+	/* Chain through the seed so the order of readbacks counts. */
+	readback_hash = xxh64(data, size, readback_hash);
+	readback_hashed = true;
+}
+
+/**
+ * Finish a PIGLIT_READBACK_HASH result line after the optional subtest
+ * name, and start over for the next result.
+ */
+static void
+report_readback_hash(void)
+{
+	printf("\"hash\": \"%016" PRIx64 "\"}}\n", readback_hash);
+	readback_hash = 0;
+	readback_hashed = false;
+}
+
+/**
+ * Return a malloc'd copy of \p s escaped for use inside a JSON string.
+ */
+static char *
+json_escape(const char *s)
+{
+	char *escaped = malloc(6 * strlen(s) + 1);
+	char *p = escaped;
+
+	for (; *s; s++) {
+		const unsigned char c = *s;
+
+		switch (c) {
+		case '"':
+		case '\\':
+			*p++ = '\\';
+			*p++ = c;
+			break;
+		case '\t':
+			p += sprintf(p, "\\t");
+			break;
+		case '\n':
+			p += sprintf(p, "\\n");
+			break;
+		case '\r':
+			p += sprintf(p, "\\r");
+			break;
+		default:
+			if (c < 0x20)
+				p += sprintf(p, "\\u%04x", c);
+			else
+				*p++ = c;
+		}
+	}
+	*p = '\0';
+
+	return escaped;
+}
+
 void
 piglit_report_result(enum piglit_result result)
 {
@@ -231,6 +444,16 @@ piglit_report_result(enum piglit_result result)
 
 	fflush(stderr);
 
+	if (getenv("PIGLIT_REPORT_RESOURCES")) {
+		printf("PIGLIT: {\"resources\": {");
+		report_resources();
+	}
+
+	if (readback_hashed) {
+		printf("PIGLIT: {\"readback_hash\": {");
+		report_readback_hash();
+	}
+
 	printf("PIGLIT: {\"result\": \"%s\" }\n", result_str);
 	fflush(stdout);
 
@@ -278,16 +501,30 @@ void
 piglit_report_subtest_result(enum piglit_result result, const char *format, ...)
 {
 	const char *result_str = piglit_result_to_string(result);
+	char buf[4096];
+	char *name;
 	va_list ap;
 
 	va_start(ap, format);
+	vsnprintf(buf, sizeof(buf), format, ap);
+	va_end(ap);
+	name = json_escape(buf);
+
+	if (getenv("PIGLIT_REPORT_RESOURCES")) {
+		printf("PIGLIT: {\"resources\": {\"subtest\": \"%s\", ", name);
+		report_resources();
+	}
 
-	printf("PIGLIT: {\"subtest\": {\"");
-	vprintf(format, ap);
-	printf("\" : \"%s\"}}\n", result_str);
+	if (readback_hashed) {
+		printf("PIGLIT: {\"readback_hash\": {\"subtest\": \"%s\", ",
+		       name);
+		report_readback_hash();
+	}
+
+	printf("PIGLIT: {\"subtest\": {\"%s\" : \"%s\"}}\n", name, result_str);
 	fflush(stdout);
 
-	va_end(ap);
+	free(name);
 }
 
 
@@ -396,6 +633,156 @@ piglit_merge_result(enum piglit_result *all, enum piglit_result subtest)
 	}
 }
 
+#if !defined(USE_STDIO)
+/**
+ * Index entry of a test source bundle, see framework/bundle.py for the
+ * file layout.  Bundles are little endian; on big endian hosts the version
+ * check fails and the bundle is ignored.
+ */
+struct bundle_entry {
+	uint64_t name_offset;
+	uint64_t data_offset;
+	uint32_t name_length;
+	uint32_t data_length;
+	int64_t mtime;
+};
+
+static struct {
+	bool initialized;
+	const uint8_t *map;
+	size_t size;
+	uint32_t num_entries;
+	uint32_t num_roots;
+	const struct bundle_entry *entries;
+} bundle;
+
+static void
+bundle_init(void)
+{
+	const char *path = getenv("PIGLIT_SHADER_BUNDLE");
+	uint64_t index_offset;
+	struct stat st;
+	void *map;
+	int fd;
+
+	bundle.initialized = true;
+	if (path == NULL)
+		return;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return;
+
+	if (fstat(fd, &st) != 0 || st.st_size < 32) {
+		close(fd);
+		return;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return;
+
+	memcpy(&bundle.num_entries, (uint8_t *) map + 12, 4);
+	memcpy(&bundle.num_roots, (uint8_t *) map + 16, 4);
+	memcpy(&index_offset, (uint8_t *) map + 24, 8);
+
+	if (memcmp(map, "PIGLITBN", 8) != 0 ||
+	    *(uint32_t *) ((uint8_t *) map + 8) != 2 ||
+	    index_offset % 8 != 0 ||
+	    index_offset + (uint64_t) bundle.num_entries *
+	    sizeof(struct bundle_entry) > (uint64_t) st.st_size) {
+		fprintf(stderr, "Ignoring invalid shader bundle %s\n", path);
+		munmap(map, st.st_size);
+		return;
+	}
+
+	bundle.map = map;
+	bundle.size = st.st_size;
+	bundle.entries = (const struct bundle_entry *)
+		(bundle.map + index_offset);
+}
+
+static const struct bundle_entry *
+bundle_find(const char *name, size_t len)
+{
+	uint32_t lo = 0, hi = bundle.num_entries;
+
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		const struct bundle_entry *e = &bundle.entries[mid];
+		int cmp = memcmp(bundle.map + e->name_offset, name,
+				 MIN2(e->name_length, len));
+
+		if (cmp == 0)
+			cmp = (e->name_length > len) - (e->name_length < len);
+		if (cmp == 0)
+			return e;
+		if (cmp < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return NULL;
+}
+
+/**
+ * Look \p file_name up in the bundle named by PIGLIT_SHADER_BUNDLE, either
+ * as a path below one of the directories the bundle was packed from or as
+ * an entry name.  Returns a malloc'ed copy of the contents, or NULL if it
+ * isn't bundled or was modified since the bundle was packed.
+ */
+static char *
+load_from_bundle(const char *file_name, unsigned *size)
+{
+	const struct bundle_entry *e = NULL;
+	const uint8_t *root;
+	uint32_t i, len;
+	struct stat st;
+	char *text;
+
+	if (!bundle.initialized)
+		bundle_init();
+	if (bundle.map == NULL)
+		return NULL;
+
+	root = bundle.map + 32;
+	for (i = 0; i < bundle.num_roots && e == NULL; i++) {
+		memcpy(&len, root, 4);
+		if (strncmp(file_name, (const char *) root + 4, len) == 0 &&
+		    file_name[len] == '/')
+			e = bundle_find(file_name + len + 1,
+					strlen(file_name + len + 1));
+		root += 4 + len;
+	}
+
+	if (e == NULL)
+		e = bundle_find(file_name, strlen(file_name));
+	if (e == NULL || e->data_offset + e->data_length > bundle.size)
+		return NULL;
+
+	/* Entries packed from a file record its mtime, edits made since
+	 * are read from disk.
+	 */
+	if (e->mtime != 0 &&
+	    (stat(file_name, &st) != 0 || st.st_mtime != e->mtime ||
+	     st.st_size != e->data_length))
+		return NULL;
+
+	text = malloc(e->data_length + 1);
+	if (text == NULL)
+		return NULL;
+
+	memcpy(text, bundle.map + e->data_offset, e->data_length);
+	text[e->data_length] = '\0';
+	if (size != NULL)
+		*size = e->data_length;
+
+	return text;
+}
+#endif
+
 char *piglit_load_text_file(const char *file_name, unsigned *size)
 {
 	char *text = NULL;
@@ -460,7 +847,13 @@ char *piglit_load_text_file(const char *file_name, unsigned *size)
 	return text;
 #else
 	struct stat st;
-	int fd = open(file_name, O_RDONLY);
+	int fd;
+
+	text = load_from_bundle(file_name, size);
+	if (text != NULL)
+		return text;
+
+	fd = open(file_name, O_RDONLY);
 
 	if (fd < 0) {
 		return NULL;
@@ -744,6 +1137,262 @@ piglit_find_subtest(const struct piglit_subtest *subtests, const char *name)
 	return NULL;
 }
 
+bool piglit_fork_subtests = false;
+
+#ifdef __linux__
+/**
+ * A subtest run in its own process by run_subtests_forked().
+ */
+struct subtest_child {
+	const struct piglit_subtest *subtest;
+	pid_t pid;
+	int status;
+	bool done;
+	FILE *out;
+	FILE *err;
+};
+
+/**
+ * Return our own command line, minus any -subtest options, with room for
+ * two more arguments and a terminating NULL, and set \p exe to the
+ * binary to exec.  When piglit-test-host runs us from a module,
+ * /proc/self describes the host, so use the command line it passes in
+ * PIGLIT_TEST_ARGV and the test binary named there.
+ */
+static char **
+get_subtest_child_argv(int *argc, const char **exe)
+{
+	static char buf[65536];
+	const char *host_argv = getenv("PIGLIT_TEST_ARGV");
+	char **argv;
+	size_t len = 0;
+	char *p;
+
+	if (host_argv) {
+		len = strlen(host_argv);
+		if (len == 0 || len >= sizeof(buf))
+			return NULL;
+		memcpy(buf, host_argv, len + 1);
+		for (p = buf; *p; p++) {
+			if (*p == '\t')
+				*p = '\0';
+		}
+		*exe = buf;
+	} else {
+		ssize_t bytes;
+		int fd = open("/proc/self/cmdline", O_RDONLY);
+
+		if (fd < 0)
+			return NULL;
+		while ((bytes = read(fd, buf + len,
+				     sizeof(buf) - 1 - len)) > 0)
+			len += bytes;
+		close(fd);
+		buf[len] = '\0';
+		*exe = "/proc/self/exe";
+	}
+
+	argv = calloc(len + 3, sizeof(char *));
+	*argc = 0;
+	for (p = buf; p < buf + len; p += strlen(p) + 1) {
+		if (streq(p, "-subtest")) {
+			p += strlen(p) + 1;
+			continue;
+		}
+		argv[(*argc)++] = p;
+	}
+
+	return argv;
+}
+
+static void
+spawn_subtest_child(struct subtest_child *child, const char *exe,
+		    char **argv, int argc)
+{
+	child->out = tmpfile();
+	child->err = tmpfile();
+
+	fflush(stdout);
+	fflush(stderr);
+
+	child->pid = fork();
+	if (child->pid == 0) {
+		dup2(fileno(child->out), STDOUT_FILENO);
+		dup2(fileno(child->err), STDERR_FILENO);
+		unsetenv("PIGLIT_SUBTEST_JOBS");
+		unsetenv("PIGLIT_TEST_ARGV");
+
+		argv[argc] = "-subtest";
+		argv[argc + 1] = (char *) child->subtest->option;
+		argv[argc + 2] = NULL;
+		execv(exe, argv);
+		_exit(127);
+	} else if (child->pid < 0) {
+		child->done = true;
+		child->status = -1;
+	}
+}
+
+static enum piglit_result
+parse_result_string(const char *s)
+{
+	if (strncmp(s, "pass\"", 5) == 0)
+		return PIGLIT_PASS;
+	if (strncmp(s, "skip\"", 5) == 0)
+		return PIGLIT_SKIP;
+	if (strncmp(s, "warn\"", 5) == 0)
+		return PIGLIT_WARN;
+	return PIGLIT_FAIL;
+}
+
+/**
+ * Forward the output of a finished child, and return its subtest's
+ * result: the subtest result it reported, else the test result it
+ * reported (e.g. a skip from piglit_init()), else fail.
+ */
+static enum piglit_result
+collect_subtest_child(struct subtest_child *child)
+{
+	static const char result_prefix[] = "PIGLIT: {\"result\": \"";
+	enum piglit_result result = PIGLIT_FAIL;
+	bool have_subtest_result = false;
+	bool have_result = false;
+	char *subtest_prefix;
+	char *name;
+	char line[4096];
+	size_t prefix_len;
+	size_t bytes;
+
+	if (child->pid < 0) {
+		piglit_loge("Failed to fork for subtest \"%s\"",
+			    child->subtest->name);
+		return PIGLIT_FAIL;
+	}
+
+	/* Match the line piglit_report_subtest_result() printed. */
+	name = json_escape(child->subtest->name);
+	(void)!asprintf(&subtest_prefix, "PIGLIT: {\"subtest\": {\"%s\" : \"",
+			name);
+	free(name);
+	prefix_len = strlen(subtest_prefix);
+
+	rewind(child->out);
+	while (fgets(line, sizeof(line), child->out)) {
+		if (strncmp(line, subtest_prefix, prefix_len) == 0) {
+			result = parse_result_string(line + prefix_len);
+			have_subtest_result = true;
+		} else if (strncmp(line, result_prefix,
+				   sizeof(result_prefix) - 1) == 0) {
+			if (!have_subtest_result) {
+				result = parse_result_string(
+					line + sizeof(result_prefix) - 1);
+				have_result = true;
+			}
+		} else {
+			fputs(line, stdout);
+		}
+	}
+	fflush(stdout);
+
+	rewind(child->err);
+	while ((bytes = fread(line, 1, sizeof(line), child->err)) > 0)
+		fwrite(line, 1, bytes, stderr);
+
+	fclose(child->out);
+	fclose(child->err);
+	free(subtest_prefix);
+
+	if (WIFSIGNALED(child->status)) {
+		piglit_loge("Subtest \"%s\" killed by signal %d",
+			    child->subtest->name, WTERMSIG(child->status));
+		return PIGLIT_FAIL;
+	}
+	if (!have_subtest_result && !have_result) {
+		piglit_loge("Subtest \"%s\" exited with status %d without "
+			    "reporting a result", child->subtest->name,
+			    WEXITSTATUS(child->status));
+	}
+
+	return result;
+}
+
+/**
+ * Run each subtest in a re-exec'd copy of the test limited to that
+ * subtest with -subtest, at most \p jobs at a time.  Each child creates
+ * its own context, and a crash only fails the subtest it happened in.
+ * Results are reported in subtest order.
+ */
+static bool
+run_subtests_forked(const struct piglit_subtest **subtests, unsigned count,
+		    unsigned jobs, enum piglit_result *result)
+{
+	struct subtest_child *children;
+	unsigned next_spawn = 0, next_report = 0, running = 0;
+	const char *exe;
+	char **argv;
+	int argc;
+
+	argv = get_subtest_child_argv(&argc, &exe);
+	if (argv == NULL)
+		return false;
+
+	children = calloc(count, sizeof(*children));
+
+	while (next_report < count) {
+		int status;
+		pid_t pid;
+		unsigned i;
+
+		while (running < jobs && next_spawn < count) {
+			children[next_spawn].subtest = subtests[next_spawn];
+			spawn_subtest_child(&children[next_spawn], exe,
+					    argv, argc);
+			if (!children[next_spawn].done)
+				running++;
+			next_spawn++;
+		}
+
+		/* Poll our own children only: the test may have others. */
+		if (running > 0) {
+			bool reaped = false;
+
+			for (i = next_report; i < next_spawn; i++) {
+				if (children[i].done)
+					continue;
+				pid = waitpid(children[i].pid, &status,
+					      WNOHANG);
+				if (pid == children[i].pid ||
+				    (pid < 0 && errno != EINTR)) {
+					children[i].status =
+						pid < 0 ? -1 : status;
+					children[i].done = true;
+					running--;
+					reaped = true;
+				}
+			}
+			if (!reaped)
+				piglit_delay_ns(1000000);
+		}
+
+		while (next_report < next_spawn &&
+		       children[next_report].done) {
+			struct subtest_child *child = &children[next_report];
+			enum piglit_result subtest_result =
+				collect_subtest_child(child);
+
+			piglit_report_subtest_result(subtest_result, "%s",
+						     child->subtest->name);
+			piglit_merge_result(result, subtest_result);
+			next_report++;
+		}
+	}
+
+	free(children);
+	free(argv);
+	return true;
+}
+#endif
+
 enum piglit_result
 piglit_run_selected_subtests(const struct piglit_subtest *all_subtests,
 			     const char **selected_subtests,
@@ -751,12 +1400,17 @@ piglit_run_selected_subtests(const struct piglit_subtest *all_subtests,
 			     enum piglit_result previous_result)
 {
 	enum piglit_result result = previous_result;
+	const struct piglit_subtest **subtests;
+	const char *jobs_str = piglit_fork_subtests ?
+		getenv("PIGLIT_SUBTEST_JOBS") : NULL;
+	unsigned jobs = jobs_str ? strtoul(jobs_str, NULL, 0) : 1;
+	unsigned count = 0;
+	unsigned i;
 
 	if (num_selected_subtests) {
-		unsigned i;
+		subtests = malloc(num_selected_subtests * sizeof(*subtests));
 
 		for (i = 0; i < num_selected_subtests; i++) {
-			enum piglit_result subtest_result;
 			const char *const name = selected_subtests[i];
 			const struct piglit_subtest *subtest =
 				piglit_find_subtest(all_subtests, name);
@@ -766,25 +1420,37 @@ piglit_run_selected_subtests(const struct piglit_subtest *all_subtests,
 				piglit_report_result(PIGLIT_FAIL);
 			}
 
-			subtest_result = subtest->subtest_func(subtest->data);
-			piglit_report_subtest_result(subtest_result, "%s",
-						     subtest->name);
-
-			piglit_merge_result(&result, subtest_result);
+			subtests[count++] = subtest;
 		}
 	} else {
-		unsigned i;
+		for (i = 0; !PIGLIT_SUBTEST_END(&all_subtests[i]); i++)
+			;
+		subtests = malloc(MAX2(i, 1) * sizeof(*subtests));
 
-		for (i = 0; !PIGLIT_SUBTEST_END(&all_subtests[i]); i++) {
-			const enum piglit_result subtest_result =
-				all_subtests[i].subtest_func(all_subtests[i].data);
-			piglit_report_subtest_result(subtest_result, "%s",
-						     all_subtests[i].name);
+		for (i = 0; !PIGLIT_SUBTEST_END(&all_subtests[i]); i++)
+			subtests[count++] = &all_subtests[i];
+	}
 
-			piglit_merge_result(&result, subtest_result);
-		}
+#ifdef __linux__
+	if (jobs > 1 && count > 1 &&
+	    run_subtests_forked(subtests, count, jobs, &result)) {
+		free(subtests);
+		return result;
+	}
+#else
+	(void) jobs;
+#endif
+
+	for (i = 0; i < count; i++) {
+		const enum piglit_result subtest_result =
+			subtests[i]->subtest_func(subtests[i]->data);
+		piglit_report_subtest_result(subtest_result, "%s",
+					     subtests[i]->name);
+
+		piglit_merge_result(&result, subtest_result);
 	}
 
+	free(subtests);
 	return result;
 }
 
@@ -145,6 +145,22 @@ struct piglit_subtest {
 const struct piglit_subtest*
 piglit_find_subtest(const struct piglit_subtest *subtests, const char *name);
 
+/**
+ * Whether the subtests may run in separate processes at the same time.
+ * Only tests whose subtests don't depend on each other should set this,
+ * GL tests through piglit_gl_test_config::fork_subtests.
+ */
+extern bool piglit_fork_subtests;
+
+/**
+ * Run the selected subtests, or all of them if none are selected, and
+ * report each result.
+ *
+ * If piglit_fork_subtests is set and PIGLIT_SUBTEST_JOBS is set to N > 1
+ * (Linux only), each subtest is instead run by re-executing the test with
+ * "-subtest <option>", up to N at a time.  Results are still reported in
+ * order, and a crashing child only fails its own subtest.
+ */
 enum piglit_result
 piglit_run_selected_subtests(const struct piglit_subtest *all_subtests,
 			     const char **selected_subtests,
@@ -361,6 +377,22 @@ void piglit_set_timeout(double seconds, enum piglit_result timeout_result);
 void piglit_report_subtest_result(enum piglit_result result,
 				  const char *format, ...) PRINTFLIKE(2, 3);
 
+/**
+ * With PIGLIT_REPORT_RESOURCES set in the environment, every reported
+ * result is preceded by a "resources" line with the peak RSS so far.  If
+ * set, this is called to print more members, each as ", \"name\": value".
+ */
+extern void (*piglit_report_resources_hook)(void);
+
+/**
+ * Whether PIGLIT_READBACK_HASH is set in the environment.  If so, probes
+ * fold the pixels they read into a 64-bit hash with
+ * piglit_readback_hash_update(), which is reported with, and reset by, the
+ * next result or subtest result.
+ */
+bool piglit_readback_hash_enabled(void);
+void piglit_readback_hash_update(const void *data, size_t size);
+
 void piglit_general_init(void);
 
 extern void piglit_set_rlimit(unsigned long lim);
@@ -428,6 +428,65 @@ class TestNames(object):
             assert getattr(self.test.names, 'all_' + attr) == \
                 getattr(self.test.names, attr)[0]
 
+    class TestNamesOutputChanges(object):
+        """summary.Names.output_changes: compares readback hashes."""
+
+        @classmethod
+        def setup_class(cls):
+            """class fixture."""
+            res1 = results.TestrunResult()
+            res1.tests['foo'] = results.TestResult('pass')
+            res1.tests['foo'].readback_hashes = {'hash': 'aaaa'}
+            res1.tests['bar'] = results.TestResult('pass')
+            res1.tests['bar'].readback_hashes = {'hash': 'aaaa'}
+            res1.tests['oink'] = results.TestResult('pass')
+            res1.tests['oink'].readback_hashes = {'hash': 'aaaa'}
+            res1.tests['tonk'] = results.TestResult('pass')
+            res1.tests['bor'] = results.TestResult('pass')
+            res1.tests['bor'].subtests['A'] = 'pass'
+            res1.tests['bor'].subtests['b'] = 'pass'
+            res1.tests['bor'].readback_hashes = {
+                'subtests': {'a': 'aaaa', 'b': 'aaaa'}}
+
+            res2 = results.TestrunResult()
+            res2.tests['foo'] = results.TestResult('pass')
+            res2.tests['foo'].readback_hashes = {'hash': 'bbbb'}
+            res2.tests['bar'] = results.TestResult('fail')
+            res2.tests['bar'].readback_hashes = {'hash': 'bbbb'}
+            res2.tests['oink'] = results.TestResult('pass')
+            res2.tests['tonk'] = results.TestResult('pass')
+            res2.tests['tonk'].readback_hashes = {'hash': 'bbbb'}
+            res2.tests['bor'] = results.TestResult('pass')
+            res2.tests['bor'].subtests['A'] = 'pass'
+            res2.tests['bor'].subtests['b'] = 'pass'
+            res2.tests['bor'].readback_hashes = {
+                'subtests': {'a': 'bbbb', 'b': 'aaaa'}}
+
+            cls.test = summary.Results([res1, res2])
+
+        def test_same_result_different_hash(self):
+            """summary.Names.output_changes: same result, new hash"""
+            assert 'foo' in self.test.names.output_changes[1]
+
+        def test_subtest(self):
+            """summary.Names.output_changes: subtest hashes, case folded"""
+            assert grouptools.join('bor', 'a') in \
+                self.test.names.output_changes[1]
+
+        def test_different_result(self):
+            """summary.Names.output_changes: result changes are left out"""
+            assert 'bar' not in self.test.names.output_changes[1]
+
+        @pytest.mark.parametrize('name', ['oink', 'tonk'])
+        def test_missing_hash(self, name):
+            """summary.Names.output_changes: needs a hash in both runs"""
+            assert name not in self.test.names.output_changes[1]
+
+        def test_exact(self):
+            """summary.Names.output_changes: nothing else is listed"""
+            assert self.test.names.output_changes == [
+                '', {'foo', grouptools.join('bor', 'a')}]
+
 
 class TestEscapeFilename(object):
     """Tests for the escape_filename function."""
@@ -23,6 +23,8 @@
 from __future__ import (
     absolute_import, division, print_function, unicode_literals
 )
+import os
+import subprocess
 import textwrap
 try:
     from unittest import mock
@@ -34,8 +36,10 @@ import pytest
 
 from framework import status
 from framework.options import _Options as Options
+from framework.test import piglit_test
 from framework.test.base import TestIsSkip as _TestIsSkip
 from framework.test.piglit_test import PiglitBaseTest, PiglitGLTest
+from .. import skip
 
 # pylint: disable=no-self-use
 # pylint: disable=protected-access
@@ -170,3 +174,115 @@ class TestPiglitGLTest(object):
             mock_options.env['PIGLIT_PLATFORM'] = 'gbm'
             test = PiglitGLTest(['foo'], exclude_platforms=['glx'])
             test.is_skip()
+
+
+class TestTestHostMixin(object):
+    """Tests for TestHostMixin."""
+
+    def test_uses_broker_display(self, mocker):
+        """test.piglit_test.TestHostMixin: tests run by the host get the
+        DISPLAY of the Xvfb broker, like exec'd ones.
+        """
+        mocker.patch('framework.test.piglit_test._USE_TEST_HOST', True)
+        mocker.patch('framework.test.piglit_test.os.path.exists',
+                     return_value=True)
+        acquire = mocker.patch('framework.test.base.xvfb.acquire',
+                               return_value=':5')
+        release = mocker.patch('framework.test.base.xvfb.release')
+        host = mocker.patch('framework.test.piglit_test._TestHost.get')
+        host.return_value.run.return_value = (1, 0, 'out', 'err', False)
+
+        test = PiglitBaseTest(['foo'])
+        test.env['FOO'] = 'bar'
+        test._run_command()
+
+        env = host.return_value.run.call_args[0][2]
+        assert env['DISPLAY'] == ':5'
+        assert env['PIGLIT_XVFB'] == '1'
+        assert env['FOO'] == 'bar'
+        acquire.assert_called_once_with()
+        release.assert_called_once_with(':5')
+        assert test.result.out == 'out'
+
+
+@skip.linux
+@pytest.mark.skipif(not os.path.exists(piglit_test._TEST_HOST),
+                    reason='piglit-test-host is not built')
+class TestTestHost(object):
+    """Tests for _TestHost, with the real piglit-test-host."""
+
+    _SOURCE = textwrap.dedent("""\
+        #include <stdio.h>
+        #include <unistd.h>
+        #include "piglit-util.h"
+
+        static enum piglit_result
+        run(void *data)
+        {
+                printf("ran in %d\\n", (int) getpid());
+                return PIGLIT_PASS;
+        }
+
+        static const struct piglit_subtest subtests[] = {
+                { "a", "a", run, NULL },
+                { "b", "b", run, NULL },
+                { NULL }
+        };
+
+        int
+        main(int argc, char **argv)
+        {
+                const char **selected = NULL;
+                size_t num_selected = 0;
+
+                piglit_fork_subtests = true;
+                piglit_parse_subtest_args(&argc, argv, subtests,
+                                          &selected, &num_selected);
+                piglit_report_result(piglit_run_selected_subtests(
+                        subtests, selected, num_selected, PIGLIT_SKIP));
+                return 0;
+        }
+        """)
+
+    @pytest.fixture
+    def test_binaries(self, tmpdir):
+        """Build a test with subtests as both a binary and a module."""
+        build_dir = os.path.dirname(piglit_test.TEST_BIN_DIR)
+        source = tmpdir.join('subtests.c')
+        source.write(self._SOURCE)
+        exe = str(tmpdir.join('subtests'))
+        module = exe + '.so'
+        flags = [
+            '-I' + os.path.join(os.path.dirname(__file__), '..', '..', '..',
+                                'tests', 'util'),
+            '-I' + os.path.join(build_dir, 'tests', 'util'),
+            '-L' + os.path.join(build_dir, 'lib'),
+            '-Wl,-rpath,' + os.path.join(build_dir, 'lib'),
+        ]
+        try:
+            subprocess.check_call(['cc', str(source), '-o', exe] + flags +
+                                  ['-lpiglitutil'])
+            subprocess.check_call(['cc', '-shared', '-fPIC', str(source),
+                                   '-o', module] + flags + ['-lpiglitutil'])
+        except (OSError, subprocess.CalledProcessError):
+            pytest.skip('cannot build a test against piglit-util')
+        return exe, module
+
+    def test_subtest_jobs(self, test_binaries):
+        """test.piglit_test._TestHost: PIGLIT_SUBTEST_JOBS runs each subtest
+        in its own copy of the test binary, not of the host.
+        """
+        exe, module = test_binaries
+        host = piglit_test._TestHost()
+        try:
+            _, returncode, out, _, _ = host.run(
+                module, [exe], {'PIGLIT_SUBTEST_JOBS': '2'}, None, 60)
+        finally:
+            host.proc.stdin.close()
+            host.proc.wait()
+
+        assert returncode == 0
+        assert out.count('ran in ') == 2
+        assert 'PIGLIT: {"subtest": {"a" : "pass"}}' in out
+        assert 'PIGLIT: {"subtest": {"b" : "pass"}}' in out
+        assert 'PIGLIT: {"result": "pass" }' in out
@@ -24,10 +24,12 @@
 from __future__ import (
     absolute_import, division, print_function, unicode_literals
 )
+import json
 
 import pytest
 import six
 
+from framework import backends
 from framework import exceptions
 from framework import grouptools
 from framework import results
@@ -300,6 +302,80 @@ class TestTestResult(object):
             test.update({'subtest': {'result': 'incomplete'}})
             assert test.subtests['result'] == 'incomplete'
 
+        def test_readback_hash(self):
+            """results.TestResult.update: readback hash of the test"""
+            test = results.TestResult('pass')
+            test.update({'readback_hash': {'hash': '0123456789abcdef'}})
+            assert test.readback_hashes == {'hash': '0123456789abcdef'}
+            assert test.result == 'pass'
+
+        def test_readback_hash_subtest(self):
+            """results.TestResult.update: readback hash of a subtest"""
+            test = results.TestResult('pass')
+            test.update({'readback_hash': {'subtest': 'Foo Bar',
+                                           'hash': '0123456789abcdef'}})
+            assert test.readback_hashes == {
+                'subtests': {'foo bar': '0123456789abcdef'}}
+            assert not test.subtests
+
+        def test_resources(self):
+            """results.TestResult.update: resources of the test"""
+            test = results.TestResult('pass')
+            test.update({'resources': {'maxrss_kb': 2048, 'textures': 3}})
+            assert test.resources == {'maxrss_kb': 2048, 'textures': 3}
+            assert test.result == 'pass'
+
+        def test_resources_subtest(self):
+            """results.TestResult.update: resources of a subtest"""
+            test = results.TestResult('pass')
+            test.update({'resources': {'subtest': 'foo', 'maxrss_kb': 1024,
+                                       'textures': 1}})
+            test.update({'resources': {'maxrss_kb': 2048, 'textures': 0}})
+            assert test.resources == {
+                'maxrss_kb': 2048,
+                'textures': 0,
+                'subtests': {'foo': {'maxrss_kb': 1024, 'textures': 1}},
+            }
+            assert not test.subtests
+
+        def test_resources_not_modified(self):
+            """results.TestResult.update: doesn't modify the parsed dict"""
+            resources = {'subtest': 'foo', 'maxrss_kb': 1024}
+            test = results.TestResult('pass')
+            test.update({'resources': resources})
+            assert resources == {'subtest': 'foo', 'maxrss_kb': 1024}
+
+    class TestRoundTrip(object):
+        """Tests for per-test reports surviving to_json and from_dict."""
+
+        @pytest.mark.parametrize("key, attrib, reports, expected", [
+            ('resources', 'resources',
+             [{'subtest': 'A', 'maxrss_kb': 1024, 'textures': 1},
+              {'maxrss_kb': 2048, 'textures': 0}],
+             {'maxrss_kb': 2048, 'textures': 0,
+              'subtests': {'a': {'maxrss_kb': 1024, 'textures': 1}}}),
+            ('readback_hash', 'readback_hashes',
+             [{'hash': 'aaaa'}, {'subtest': 'A', 'hash': 'bbbb'}],
+             {'hash': 'aaaa', 'subtests': {'a': 'bbbb'}}),
+        ])
+        def test_round_trip(self, key, attrib, reports, expected):
+            """results.TestResult: reports survive serialization, with
+            lowercased subtest names
+            """
+            test = results.TestResult('pass')
+            for report in reports:
+                test.update({key: report})
+
+            new = results.TestResult.from_dict(json.loads(json.dumps(
+                test.to_json(), default=backends.json.piglit_encoder)))
+            assert getattr(new, attrib) == expected
+
+        @pytest.mark.parametrize("attrib", ['resources', 'readback_hashes'])
+        def test_missing(self, attrib):
+            """results.TestResult.from_dict: reports default to empty"""
+            test = results.TestResult.from_dict({'result': 'pass'})
+            assert getattr(test, attrib) == {}
+
     class TestTotals(object):
         """Test the totals generated by TestrunResult.calculate_group_totals().
         """
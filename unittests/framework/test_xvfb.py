@@ -0,0 +1,93 @@
+# Copyright © 2026 The Piglit project
+
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+"""Tests for the xvfb module."""
+
+from __future__ import (
+    absolute_import, division, print_function, unicode_literals
+)
+import itertools
+
+import pytest
+
+from framework import exceptions
+from framework import xvfb
+
+# pylint: disable=no-self-use
+
+
+class TestXvfbBroker(object):
+    """Tests for XvfbBroker, with fake servers."""
+
+    @pytest.fixture
+    def broker(self, mocker):
+        numbers = itertools.count()
+        mocker.patch(
+            'framework.xvfb.XvfbBroker._start_server',
+            side_effect=lambda _: (mocker.Mock(),
+                                   ':{}'.format(next(numbers))))
+        return xvfb.XvfbBroker(3)
+
+    def test_displays(self, broker):
+        """xvfb.XvfbBroker: starts the requested number of servers."""
+        assert broker.displays == [':0', ':1', ':2']
+
+    def test_acquire_spreads(self, broker):
+        """xvfb.XvfbBroker.acquire: uses every server before reusing one."""
+        got = [broker.acquire() for _ in range(3)]
+        assert sorted(got) == [':0', ':1', ':2']
+
+    def test_acquire_least_busy(self, broker):
+        """xvfb.XvfbBroker.acquire: picks the server running fewest tests."""
+        first = [broker.acquire() for _ in range(6)]
+        broker.release(first[4])
+        assert broker.acquire() == first[4]
+
+    def test_stop(self, broker):
+        """xvfb.XvfbBroker.stop: terminates every server."""
+        procs = list(broker._procs)  # pylint: disable=protected-access
+        broker.stop()
+        for proc in procs:
+            proc.terminate.assert_called_once_with()
+            proc.wait.assert_called_once_with()
+
+
+class TestModule(object):
+    """Tests for the module level broker."""
+
+    def test_no_broker(self):
+        """xvfb.acquire: returns None when no broker was started."""
+        xvfb.start(0)
+        try:
+            assert xvfb.acquire() is None
+            xvfb.release(None)
+        finally:
+            xvfb.stop()
+
+    def test_display_env(self):
+        """xvfb.display_env: marks broker displays for the caps key."""
+        assert xvfb.display_env(None) == {}
+        assert xvfb.display_env(':5') == {'DISPLAY': ':5', 'PIGLIT_XVFB': '1'}
+
+    def test_missing_xvfb(self):
+        """xvfb.XvfbBroker: raises PiglitFatalError if Xvfb can't start."""
+        with pytest.raises(exceptions.PiglitFatalError):
+            xvfb.XvfbBroker(1, xvfb='/nonexistent/Xvfb')